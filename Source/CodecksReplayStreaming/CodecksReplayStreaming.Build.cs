@@ -0,0 +1,25 @@
+using UnrealBuildTool;
+
+public class CodecksReplayStreaming : ModuleRules
+{
+	public CodecksReplayStreaming(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		PublicDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"Core",
+				"NetworkReplayStreaming",
+			}
+		);
+
+		PrivateDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"CoreUObject",
+				"Engine",
+			}
+		);
+	}
+}
@@ -0,0 +1,228 @@
+// Copyright(C) battyRabbit UG (limited liability). All Rights Reserved.
+
+#include "CodecksReplayRingBuffer.h"
+
+#include "CodecksReplayStreaming.h"
+
+#include <Misc/Compression.h>
+#include <Misc/ScopeLock.h>
+#include <Serialization/MemoryReader.h>
+#include <Serialization/MemoryWriter.h>
+
+namespace CodecksReplayRingBuffer
+{
+	constexpr uint32 Magic = 0x50524443; // "CDRP"
+	constexpr uint32 Version = 1;
+
+	void SerializeSegment(FArchive& Ar, FCodecksReplaySegment& Segment)
+	{
+		Ar << Segment.StartTimeMS;
+		Ar << Segment.EndTimeMS;
+		Ar << Segment.bHasCheckpoint;
+		Ar << Segment.Checkpoint;
+		Ar << Segment.Stream;
+	}
+}
+
+bool FCodecksReplaySnapshot::Save(TArray64<uint8>& OutCompressed) const
+{
+	TArray<uint8> Uncompressed;
+	FMemoryWriter Writer(Uncompressed);
+
+	TArray<uint8> HeaderCopy = Header;
+	Writer << HeaderCopy;
+
+	int32 NumSegments = Segments.Num();
+	Writer << NumSegments;
+	for (const FCodecksReplaySegmentRef& Segment : Segments)
+	{
+		// Serialization wants mutable access even when saving
+		CodecksReplayRingBuffer::SerializeSegment(Writer, const_cast<FCodecksReplaySegment&>(Segment.Get()));
+	}
+
+	int32 CompressedSize = FCompression::CompressMemoryBound(NAME_Zlib, Uncompressed.Num());
+
+	TArray<uint8> Compressed;
+	Compressed.SetNumUninitialized(CompressedSize);
+	if (!FCompression::CompressMemory(NAME_Zlib, Compressed.GetData(), CompressedSize, Uncompressed.GetData(), Uncompressed.Num()))
+	{
+		return false;
+	}
+	Compressed.SetNum(CompressedSize, /*bAllowShrinking=*/false);
+
+	OutCompressed.Reset();
+	FMemoryWriter64 ContainerWriter(OutCompressed);
+
+	uint32 Magic = CodecksReplayRingBuffer::Magic;
+	uint32 Version = CodecksReplayRingBuffer::Version;
+	int32 UncompressedSize = Uncompressed.Num();
+	ContainerWriter << Magic << Version << UncompressedSize;
+	ContainerWriter.Serialize(Compressed.GetData(), Compressed.Num());
+
+	return !ContainerWriter.IsError();
+}
+
+bool FCodecksReplaySnapshot::Load(const TArray<uint8>& Compressed)
+{
+	FMemoryReader ContainerReader(Compressed);
+
+	uint32 Magic = 0;
+	uint32 Version = 0;
+	int32 UncompressedSize = 0;
+	ContainerReader << Magic << Version << UncompressedSize;
+
+	if (ContainerReader.IsError() || Magic != CodecksReplayRingBuffer::Magic || Version != CodecksReplayRingBuffer::Version || UncompressedSize < 0)
+	{
+		return false;
+	}
+
+	TArray<uint8> Uncompressed;
+	Uncompressed.SetNumUninitialized(UncompressedSize);
+
+	const int64 Offset = ContainerReader.Tell();
+	if (!FCompression::UncompressMemory(NAME_Zlib, Uncompressed.GetData(), UncompressedSize, Compressed.GetData() + Offset, Compressed.Num() - Offset))
+	{
+		return false;
+	}
+
+	FMemoryReader Reader(Uncompressed);
+	Reader << Header;
+
+	int32 NumSegments = 0;
+	Reader << NumSegments;
+
+	Segments.Reset();
+	for (int32 SegmentIndex = 0; SegmentIndex < NumSegments && !Reader.IsError(); ++SegmentIndex)
+	{
+		TSharedRef<FCodecksReplaySegment, ESPMode::ThreadSafe> Segment = MakeShared<FCodecksReplaySegment, ESPMode::ThreadSafe>();
+		CodecksReplayRingBuffer::SerializeSegment(Reader, Segment.Get());
+		Segments.Add(Segment);
+	}
+
+	return !Reader.IsError();
+}
+
+FCodecksReplayRingBuffer& FCodecksReplayRingBuffer::Get()
+{
+	static FCodecksReplayRingBuffer RingBuffer;
+	return RingBuffer;
+}
+
+void FCodecksReplayRingBuffer::Configure(float InMaxSeconds, int64 InMaxBytes)
+{
+	FScopeLock Lock(&Mutex);
+
+	MaxSeconds = FMath::Max(InMaxSeconds, 1.0f);
+	MaxBytes = FMath::Max<int64>(InMaxBytes, 1024 * 1024);
+
+	Evict();
+}
+
+void FCodecksReplayRingBuffer::Reset()
+{
+	FScopeLock Lock(&Mutex);
+
+	Header.Reset();
+	ClosedSegments.Reset();
+	ClosedSegmentsSize = 0;
+	OpenSegment = FCodecksReplaySegment();
+	bWaitingForCheckpoint = false;
+}
+
+void FCodecksReplayRingBuffer::SetHeader(TArray<uint8>&& InHeader)
+{
+	FScopeLock Lock(&Mutex);
+	Header = MoveTemp(InHeader);
+}
+
+void FCodecksReplayRingBuffer::AppendStream(const uint8* Data, int64 Num, uint32 TimeMS)
+{
+	FScopeLock Lock(&Mutex);
+
+	if (bWaitingForCheckpoint)
+	{
+		return;
+	}
+
+	OpenSegment.Stream.Append(Data, Num);
+	OpenSegment.EndTimeMS = FMath::Max(OpenSegment.EndTimeMS, TimeMS);
+
+	Evict();
+}
+
+void FCodecksReplayRingBuffer::AddCheckpoint(TArray<uint8>&& Checkpoint, uint32 TimeMS)
+{
+	FScopeLock Lock(&Mutex);
+
+	if (!bWaitingForCheckpoint)
+	{
+		OpenSegment.EndTimeMS = FMath::Max(OpenSegment.EndTimeMS, TimeMS);
+		OpenSegment.Stream.Shrink();
+
+		ClosedSegmentsSize += OpenSegment.GetAllocatedSize();
+		ClosedSegments.Add(MakeShared<const FCodecksReplaySegment, ESPMode::ThreadSafe>(MoveTemp(OpenSegment)));
+	}
+
+	bWaitingForCheckpoint = false;
+
+	OpenSegment = FCodecksReplaySegment();
+	OpenSegment.StartTimeMS = TimeMS;
+	OpenSegment.EndTimeMS = TimeMS;
+	OpenSegment.bHasCheckpoint = true;
+	OpenSegment.Checkpoint = MoveTemp(Checkpoint);
+
+	Evict();
+}
+
+FCodecksReplaySnapshot FCodecksReplayRingBuffer::Snapshot() const
+{
+	FScopeLock Lock(&Mutex);
+
+	FCodecksReplaySnapshot Snapshot;
+	Snapshot.Header = Header;
+	Snapshot.Segments = ClosedSegments;
+
+	if (!bWaitingForCheckpoint && (OpenSegment.bHasCheckpoint || OpenSegment.Stream.Num() > 0))
+	{
+		Snapshot.Segments.Add(MakeShared<const FCodecksReplaySegment, ESPMode::ThreadSafe>(OpenSegment));
+	}
+
+	return Snapshot;
+}
+
+int64 FCodecksReplayRingBuffer::GetAllocatedSize() const
+{
+	FScopeLock Lock(&Mutex);
+	return Header.GetAllocatedSize() + ClosedSegmentsSize + OpenSegment.GetAllocatedSize();
+}
+
+void FCodecksReplayRingBuffer::Evict()
+{
+	const uint32 WindowMS = static_cast<uint32>(MaxSeconds * 1000.0f);
+	const uint32 NowMS = OpenSegment.EndTimeMS;
+
+	while (ClosedSegments.Num() > 0)
+	{
+		// The oldest segment is only needed while the one after it starts inside the window
+		const uint32 NextStartMS = ClosedSegments.Num() > 1 ? ClosedSegments[1]->StartTimeMS : OpenSegment.StartTimeMS;
+		const bool bOutsideWindow = NowMS > WindowMS && NextStartMS <= NowMS - WindowMS;
+		const bool bOverBudget = Header.GetAllocatedSize() + ClosedSegmentsSize + OpenSegment.GetAllocatedSize() > MaxBytes;
+
+		if (!bOutsideWindow && !bOverBudget)
+		{
+			break;
+		}
+
+		ClosedSegmentsSize -= ClosedSegments[0]->GetAllocatedSize();
+		ClosedSegments.RemoveAt(0, 1, /*bAllowShrinking=*/false);
+	}
+
+	// Nothing left to drop but the segment being recorded, so it has to go as a whole
+	if (ClosedSegments.Num() == 0 && Header.GetAllocatedSize() + OpenSegment.GetAllocatedSize() > MaxBytes)
+	{
+		UE_LOG(LogCodecksReplayStreaming, Warning, TEXT("Replay segment exceeds the memory cap of %lld bytes, dropping it until the next checkpoint. Lower the checkpoint interval or raise the cap."), MaxBytes);
+
+		OpenSegment = FCodecksReplaySegment();
+		bWaitingForCheckpoint = true;
+	}
+}
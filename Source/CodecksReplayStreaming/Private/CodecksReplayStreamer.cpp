@@ -0,0 +1,404 @@
+// Copyright(C) battyRabbit UG (limited liability). All Rights Reserved.
+
+#include "CodecksReplayStreamer.h"
+
+#include "CodecksReplayStreaming.h"
+
+#include <Engine/DemoNetDriver.h>
+#include <Engine/Engine.h>
+#include <Engine/World.h>
+#include <HAL/FileManager.h>
+#include <Misc/FileHelper.h>
+#include <Misc/Paths.h>
+
+namespace CodecksReplayStreamer
+{
+	template<typename ResultType, typename DelegateType>
+	void Unsupported(const DelegateType& Delegate)
+	{
+		ResultType Result;
+		Result.Result = EStreamingOperationResult::Unsupported;
+		Delegate.ExecuteIfBound(Result);
+	}
+}
+
+const FString FCodecksReplayStreamer::FileExtension = TEXT(".codecksreplay");
+
+FCodecksReplayStreamArchive::FCodecksReplayStreamArchive()
+{
+	SetIsSaving(true);
+	SetIsPersistent(false);
+}
+
+void FCodecksReplayStreamArchive::Serialize(void* Data, int64 Num)
+{
+	FCodecksReplayRingBuffer::Get().AppendStream(static_cast<const uint8*>(Data), Num, TimeMS);
+	Size += Num;
+}
+
+FCodecksReplayStreamer::~FCodecksReplayStreamer()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(WindowStartHandle);
+}
+
+void FCodecksReplayStreamer::StartStreaming(const FStartStreamingParameters& Params, const FStartStreamingCallback& Delegate)
+{
+	ReplayName = Params.CustomName;
+	bRecording = Params.bRecord;
+	TotalDemoTimeMS = 0;
+
+	FStartStreamingResult Result;
+	Result.bRecording = bRecording;
+
+	if (bRecording)
+	{
+		FCodecksReplayRingBuffer::Get().Reset();
+
+		HeaderBuffer.Reset();
+		HeaderWriter.Seek(0);
+		PushedHeaderSize = 0;
+
+		StreamArchive.Reset();
+
+		CheckpointBuffer.Reset();
+		CheckpointWriter.Seek(0);
+
+		bStreaming = true;
+	}
+	else
+	{
+		bStreaming = LoadPlayback(GetReplayFilename(ReplayName));
+	}
+
+	Result.Result = bStreaming ? EStreamingOperationResult::Success : EStreamingOperationResult::FinishedWithError;
+	Delegate.ExecuteIfBound(Result);
+}
+
+void FCodecksReplayStreamer::StopStreaming()
+{
+	if (bRecording && bStreaming)
+	{
+		PushHeader();
+	}
+
+	bStreaming = false;
+	bAwaitingWindowStart = false;
+
+	FTSTicker::GetCoreTicker().RemoveTicker(WindowStartHandle);
+	WindowStartHandle.Reset();
+}
+
+FArchive* FCodecksReplayStreamer::GetHeaderArchive()
+{
+	return bRecording ? static_cast<FArchive*>(&HeaderWriter) : &HeaderReader;
+}
+
+FArchive* FCodecksReplayStreamer::GetStreamingArchive()
+{
+	return bRecording ? static_cast<FArchive*>(&StreamArchive) : &StreamReader;
+}
+
+FArchive* FCodecksReplayStreamer::GetCheckpointArchive()
+{
+	return bRecording ? static_cast<FArchive*>(&CheckpointWriter) : &CheckpointReader;
+}
+
+void FCodecksReplayStreamer::FlushCheckpoint(const uint32 TimeInMS)
+{
+	if (!bRecording || !bStreaming)
+	{
+		return;
+	}
+
+	PushHeader();
+
+	// Stream written from here on belongs to the segment this checkpoint opens
+	FCodecksReplayRingBuffer::Get().AddCheckpoint(MoveTemp(CheckpointBuffer), TimeInMS);
+
+	CheckpointBuffer.Reset();
+	CheckpointWriter.Seek(0);
+}
+
+void FCodecksReplayStreamer::GotoCheckpointIndex(const int32 CheckpointIndex, const FGotoCallback& Delegate, EReplayCheckpointType CheckpointType)
+{
+	int32 Remaining = CheckpointIndex;
+	for (const FCodecksReplaySegmentRef& Segment : Playback.Segments)
+	{
+		if (Segment->bHasCheckpoint && Remaining-- == 0)
+		{
+			GotoTimeInMS(Segment->StartTimeMS, Delegate, CheckpointType);
+			return;
+		}
+	}
+
+	// INDEX_NONE or out of range, either way the best we have is the start of the window
+	GotoTimeInMS(0, Delegate, CheckpointType);
+}
+
+void FCodecksReplayStreamer::GotoTimeInMS(const uint32 TimeInMS, const FGotoCallback& Delegate, EReplayCheckpointType CheckpointType)
+{
+	FGotoResult Result;
+
+	if (bRecording || !bStreaming || CheckpointType != EReplayCheckpointType::Full)
+	{
+		Result.Result = EStreamingOperationResult::Unsupported;
+		Delegate.ExecuteIfBound(Result);
+		return;
+	}
+
+	// Times before the window clamp to its first segment
+	int32 SegmentIndex = 0;
+	while (SegmentIndex + 1 < Playback.Segments.Num() && Playback.Segments[SegmentIndex + 1]->StartTimeMS <= TimeInMS)
+	{
+		++SegmentIndex;
+	}
+
+	const FCodecksReplaySegment& Segment = Playback.Segments[SegmentIndex].Get();
+
+	// An empty checkpoint tells the demo driver to start over from the beginning of the stream
+	PlaybackCheckpoint = Segment.bHasCheckpoint ? Segment.Checkpoint : TArray<uint8>();
+	CheckpointReader.Seek(0);
+	StreamReader.Seek(SegmentOffsets[SegmentIndex]);
+
+	bAwaitingWindowStart = false;
+
+	Result.Result = EStreamingOperationResult::Success;
+	Result.ExtraTimeMS = FMath::Max(TimeInMS, Segment.StartTimeMS) - Segment.StartTimeMS;
+	Result.CheckpointInfo.CheckpointIndex = Segment.bHasCheckpoint ? SegmentIndex : INDEX_NONE;
+	Result.CheckpointInfo.CheckpointStartTime = Segment.StartTimeMS;
+	Delegate.ExecuteIfBound(Result);
+}
+
+void FCodecksReplayStreamer::UpdateTotalDemoTime(uint32 TimeInMS)
+{
+	if (!bRecording)
+	{
+		return;
+	}
+
+	TotalDemoTimeMS = TimeInMS;
+	StreamArchive.TimeMS = TimeInMS;
+
+	PushHeader();
+}
+
+bool FCodecksReplayStreamer::IsDataAvailable() const
+{
+	return bStreaming && (bRecording || !bAwaitingWindowStart);
+}
+
+void FCodecksReplayStreamer::DeleteFinishedStream(const FString& StreamName, const FDeleteFinishedStreamCallback& Delegate)
+{
+	DeleteFinishedStream(StreamName, INDEX_NONE, Delegate);
+}
+
+void FCodecksReplayStreamer::DeleteFinishedStream(const FString& StreamName, const int32 UserIndex, const FDeleteFinishedStreamCallback& Delegate)
+{
+	FDeleteFinishedStreamResult Result;
+	Result.Result = IFileManager::Get().Delete(*GetReplayFilename(StreamName)) ? EStreamingOperationResult::Success : EStreamingOperationResult::FinishedWithError;
+	Delegate.ExecuteIfBound(Result);
+}
+
+void FCodecksReplayStreamer::EnumerateStreams(const FNetworkReplayVersion& InReplayVersion, const int32 UserIndex, const FString& MetaString, const TArray<FString>& ExtraParms, const FEnumerateStreamsCallback& Delegate)
+{
+	CodecksReplayStreamer::Unsupported<FEnumerateStreamsResult>(Delegate);
+}
+
+void FCodecksReplayStreamer::EnumerateRecentStreams(const FNetworkReplayVersion& ReplayVersion, const int32 UserIndex, const FEnumerateStreamsCallback& Delegate)
+{
+	CodecksReplayStreamer::Unsupported<FEnumerateStreamsResult>(Delegate);
+}
+
+void FCodecksReplayStreamer::EnumerateEvents(const FString& Group, const FEnumerateEventsCallback& Delegate)
+{
+	CodecksReplayStreamer::Unsupported<FEnumerateEventsResult>(Delegate);
+}
+
+void FCodecksReplayStreamer::EnumerateEvents(const FString& InReplayName, const FString& Group, const FEnumerateEventsCallback& Delegate)
+{
+	CodecksReplayStreamer::Unsupported<FEnumerateEventsResult>(Delegate);
+}
+
+void FCodecksReplayStreamer::EnumerateEvents(const FString& InReplayName, const FString& Group, const int32 UserIndex, const FEnumerateEventsCallback& Delegate)
+{
+	CodecksReplayStreamer::Unsupported<FEnumerateEventsResult>(Delegate);
+}
+
+void FCodecksReplayStreamer::RequestEventData(const FString& EventID, const FRequestEventDataCallback& Delegate)
+{
+	CodecksReplayStreamer::Unsupported<FRequestEventDataResult>(Delegate);
+}
+
+void FCodecksReplayStreamer::RequestEventData(const FString& InReplayName, const FString& EventID, const FRequestEventDataCallback& Delegate)
+{
+	CodecksReplayStreamer::Unsupported<FRequestEventDataResult>(Delegate);
+}
+
+void FCodecksReplayStreamer::RequestEventData(const FString& InReplayName, const FString& EventId, const int32 UserIndex, const FRequestEventDataCallback& Delegate)
+{
+	CodecksReplayStreamer::Unsupported<FRequestEventDataResult>(Delegate);
+}
+
+void FCodecksReplayStreamer::RequestEventGroupData(const FString& Group, const FRequestEventGroupDataCallback& Delegate)
+{
+	CodecksReplayStreamer::Unsupported<FRequestEventGroupDataResult>(Delegate);
+}
+
+void FCodecksReplayStreamer::RequestEventGroupData(const FString& InReplayName, const FString& Group, const FRequestEventGroupDataCallback& Delegate)
+{
+	CodecksReplayStreamer::Unsupported<FRequestEventGroupDataResult>(Delegate);
+}
+
+void FCodecksReplayStreamer::RequestEventGroupData(const FString& InReplayName, const FString& Group, const int32 UserIndex, const FRequestEventGroupDataCallback& Delegate)
+{
+	CodecksReplayStreamer::Unsupported<FRequestEventGroupDataResult>(Delegate);
+}
+
+void FCodecksReplayStreamer::SearchEvents(const FString& EventGroup, const FSearchEventsCallback& Delegate)
+{
+	CodecksReplayStreamer::Unsupported<FSearchEventsResult>(Delegate);
+}
+
+void FCodecksReplayStreamer::KeepReplay(const FString& InReplayName, const bool bKeep, const FKeepReplayCallback& Delegate)
+{
+	CodecksReplayStreamer::Unsupported<FKeepReplayResult>(Delegate);
+}
+
+void FCodecksReplayStreamer::KeepReplay(const FString& InReplayName, const bool bKeep, const int32 UserIndex, const FKeepReplayCallback& Delegate)
+{
+	CodecksReplayStreamer::Unsupported<FKeepReplayResult>(Delegate);
+}
+
+void FCodecksReplayStreamer::RenameReplayFriendlyName(const FString& InReplayName, const FString& NewFriendlyName, const FRenameReplayCallback& Delegate)
+{
+	CodecksReplayStreamer::Unsupported<FRenameReplayResult>(Delegate);
+}
+
+void FCodecksReplayStreamer::RenameReplayFriendlyName(const FString& InReplayName, const FString& NewFriendlyName, const int32 UserIndex, const FRenameReplayCallback& Delegate)
+{
+	CodecksReplayStreamer::Unsupported<FRenameReplayResult>(Delegate);
+}
+
+void FCodecksReplayStreamer::RenameReplay(const FString& InReplayName, const FString& NewName, const FRenameReplayCallback& Delegate)
+{
+	CodecksReplayStreamer::Unsupported<FRenameReplayResult>(Delegate);
+}
+
+void FCodecksReplayStreamer::RenameReplay(const FString& InReplayName, const FString& NewName, const int32 UserIndex, const FRenameReplayCallback& Delegate)
+{
+	CodecksReplayStreamer::Unsupported<FRenameReplayResult>(Delegate);
+}
+
+void FCodecksReplayStreamer::RefreshHeader()
+{
+	if (bRecording)
+	{
+		// The driver may have rewritten the header in place, so don't rely on its size changing
+		PushedHeaderSize = INDEX_NONE;
+		PushHeader();
+	}
+}
+
+void FCodecksReplayStreamer::DownloadHeader(const FDownloadHeaderCallback& Delegate)
+{
+	// Playback loads the whole file up front, header included
+	FDownloadHeaderResult Result;
+	Result.Result = bStreaming ? EStreamingOperationResult::Success : EStreamingOperationResult::FinishedWithError;
+	Delegate.ExecuteIfBound(Result);
+}
+
+bool FCodecksReplayStreamer::GetDemoPath(FString& DemoPath) const
+{
+	DemoPath = GetDemoDirectory();
+	return true;
+}
+
+FString FCodecksReplayStreamer::GetDemoDirectory()
+{
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Demos/"));
+}
+
+FString FCodecksReplayStreamer::GetReplayFilename(const FString& Name)
+{
+	const FString DemoPath = GetDemoDirectory();
+
+	if (FPaths::GetExtension(Name, /*bIncludeDot=*/true) == FileExtension)
+	{
+		return FPaths::IsRelative(Name) ? FPaths::Combine(DemoPath, Name) : Name;
+	}
+
+	return FPaths::Combine(DemoPath, Name + FileExtension);
+}
+
+void FCodecksReplayStreamer::PushHeader()
+{
+	if (HeaderBuffer.Num() != PushedHeaderSize)
+	{
+		FCodecksReplayRingBuffer::Get().SetHeader(TArray<uint8>(HeaderBuffer));
+		PushedHeaderSize = HeaderBuffer.Num();
+	}
+}
+
+bool FCodecksReplayStreamer::LoadPlayback(const FString& Filename)
+{
+	TArray<uint8> Compressed;
+	if (!FFileHelper::LoadFileToArray(Compressed, *Filename))
+	{
+		UE_LOG(LogCodecksReplayStreaming, Warning, TEXT("Could not read replay %s"), *Filename);
+		return false;
+	}
+
+	if (!Playback.Load(Compressed) || Playback.IsEmpty())
+	{
+		UE_LOG(LogCodecksReplayStreaming, Warning, TEXT("%s is not a valid codecks replay"), *Filename);
+		return false;
+	}
+
+	PlaybackStream.Reset();
+	SegmentOffsets.Reset(Playback.Segments.Num());
+	for (const FCodecksReplaySegmentRef& Segment : Playback.Segments)
+	{
+		SegmentOffsets.Add(PlaybackStream.Num());
+		PlaybackStream.Append(Segment->Stream);
+	}
+
+	// Frames in the stream carry the times they were recorded at, so the window keeps those rather than starting at 0
+	TotalDemoTimeMS = Playback.Segments.Last()->EndTimeMS;
+
+	HeaderReader.Seek(0);
+	StreamReader.Seek(0);
+	PlaybackCheckpoint.Reset();
+	CheckpointReader.Seek(0);
+
+	bAwaitingWindowStart = Playback.Segments[0]->bHasCheckpoint;
+	if (bAwaitingWindowStart)
+	{
+		WindowStartHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FCodecksReplayStreamer::GotoWindowStart));
+	}
+
+	return true;
+}
+
+bool FCodecksReplayStreamer::GotoWindowStart(float /*DeltaTime*/)
+{
+	if (!bAwaitingWindowStart || !GEngine)
+	{
+		return bAwaitingWindowStart;
+	}
+
+	for (const FWorldContext& WorldContext : GEngine->GetWorldContexts())
+	{
+		UWorld* World = WorldContext.World();
+		UDemoNetDriver* DemoNetDriver = World ? World->GetDemoNetDriver() : nullptr;
+
+		// Wait for the driver to finish reading the header before moving it
+		if (DemoNetDriver && DemoNetDriver->ServerConnection && DemoNetDriver->GetReplayStreamer().Get() == this)
+		{
+			DemoNetDriver->GotoTimeInSeconds(Playback.Segments[0]->StartTimeMS / 1000.0f);
+			WindowStartHandle.Reset();
+			return false;
+		}
+	}
+
+	return true;
+}
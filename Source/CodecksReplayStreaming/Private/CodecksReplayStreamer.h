@@ -0,0 +1,146 @@
+// Copyright(C) battyRabbit UG (limited liability). All Rights Reserved.
+
+#pragma once
+
+#include <CoreMinimal.h>
+
+#include "CodecksReplayRingBuffer.h"
+
+#include <Containers/Ticker.h>
+#include <NetworkReplayStreaming.h>
+#include <Serialization/MemoryReader.h>
+#include <Serialization/MemoryWriter.h>
+
+/**
+ * Write-only archive appending everything the demo driver streams straight into the ring buffer.
+ */
+class FCodecksReplayStreamArchive : public FArchive
+{
+public:
+	FCodecksReplayStreamArchive();
+
+	virtual void Serialize(void* Data, int64 Num) override;
+	virtual int64 Tell() override { return Size; }
+	virtual int64 TotalSize() override { return Size; }
+	virtual FString GetArchiveName() const override { return TEXT("FCodecksReplayStreamArchive"); }
+
+	void Reset() { TimeMS = 0; Size = 0; }
+
+	uint32 TimeMS = 0;
+
+private:
+	int64 Size = 0;
+};
+
+/**
+ * Replay streamer recording into FCodecksReplayRingBuffer and playing back files saved from it.
+ *
+ * Playback stitches the segment streams back together. The window usually starts at a checkpoint rather than at the
+ * beginning of the match, so the streamer holds back data until the demo driver went to that checkpoint.
+ */
+class FCodecksReplayStreamer : public INetworkReplayStreamer
+{
+public:
+	static const FString FileExtension;
+
+	virtual ~FCodecksReplayStreamer() override;
+
+	/** INetworkReplayStreamer implementation */
+	virtual void StartStreaming(const FStartStreamingParameters& Params, const FStartStreamingCallback& Delegate) override;
+	virtual void StopStreaming() override;
+	virtual FArchive* GetHeaderArchive() override;
+	virtual FArchive* GetStreamingArchive() override;
+	virtual FArchive* GetCheckpointArchive() override;
+	virtual void FlushCheckpoint(const uint32 TimeInMS) override;
+	virtual void GotoCheckpointIndex(const int32 CheckpointIndex, const FGotoCallback& Delegate, EReplayCheckpointType CheckpointType) override;
+	virtual void GotoTimeInMS(const uint32 TimeInMS, const FGotoCallback& Delegate, EReplayCheckpointType CheckpointType) override;
+	virtual void UpdateTotalDemoTime(uint32 TimeInMS) override;
+	virtual void UpdatePlaybackTime(uint32 TimeInMS) override {}
+	virtual uint32 GetTotalDemoTime() const override { return TotalDemoTimeMS; }
+	virtual bool IsDataAvailable() const override;
+	virtual void SetHighPriorityTimeRange(const uint32 StartTimeInMS, const uint32 EndTimeInMS) override {}
+	virtual bool IsDataAvailableForTimeRange(const uint32 StartTimeInMS, const uint32 EndTimeInMS) override { return IsDataAvailable(); }
+	virtual bool IsLoadingCheckpoint() const override { return false; }
+	virtual bool IsLive() const override { return false; }
+	virtual void DeleteFinishedStream(const FString& StreamName, const FDeleteFinishedStreamCallback& Delegate) override;
+	virtual void DeleteFinishedStream(const FString& StreamName, const int32 UserIndex, const FDeleteFinishedStreamCallback& Delegate) override;
+	virtual void EnumerateStreams(const FNetworkReplayVersion& InReplayVersion, const int32 UserIndex, const FString& MetaString, const TArray<FString>& ExtraParms, const FEnumerateStreamsCallback& Delegate) override;
+	virtual void EnumerateRecentStreams(const FNetworkReplayVersion& ReplayVersion, const int32 UserIndex, const FEnumerateStreamsCallback& Delegate) override;
+	virtual void AddUserToReplay(const FString& UserString) override {}
+	virtual void AddEvent(const uint32 TimeInMS, const FString& Group, const FString& Meta, const TArray<uint8>& Data) override {}
+	virtual void AddOrUpdateEvent(const FString& Name, const uint32 TimeInMS, const FString& Group, const FString& Meta, const TArray<uint8>& Data) override {}
+	virtual void EnumerateEvents(const FString& Group, const FEnumerateEventsCallback& Delegate) override;
+	virtual void EnumerateEvents(const FString& ReplayName, const FString& Group, const FEnumerateEventsCallback& Delegate) override;
+	virtual void EnumerateEvents(const FString& ReplayName, const FString& Group, const int32 UserIndex, const FEnumerateEventsCallback& Delegate) override;
+	virtual void RequestEventData(const FString& EventID, const FRequestEventDataCallback& Delegate) override;
+	virtual void RequestEventData(const FString& ReplayName, const FString& EventID, const FRequestEventDataCallback& Delegate) override;
+	virtual void RequestEventData(const FString& ReplayName, const FString& EventId, const int32 UserIndex, const FRequestEventDataCallback& Delegate) override;
+	virtual void RequestEventGroupData(const FString& Group, const FRequestEventGroupDataCallback& Delegate) override;
+	virtual void RequestEventGroupData(const FString& ReplayName, const FString& Group, const FRequestEventGroupDataCallback& Delegate) override;
+	virtual void RequestEventGroupData(const FString& ReplayName, const FString& Group, const int32 UserIndex, const FRequestEventGroupDataCallback& Delegate) override;
+	virtual void SearchEvents(const FString& EventGroup, const FSearchEventsCallback& Delegate) override;
+	virtual void KeepReplay(const FString& ReplayName, const bool bKeep, const FKeepReplayCallback& Delegate) override;
+	virtual void KeepReplay(const FString& ReplayName, const bool bKeep, const int32 UserIndex, const FKeepReplayCallback& Delegate) override;
+	virtual void RenameReplayFriendlyName(const FString& ReplayName, const FString& NewFriendlyName, const FRenameReplayCallback& Delegate) override;
+	virtual void RenameReplayFriendlyName(const FString& ReplayName, const FString& NewFriendlyName, const int32 UserIndex, const FRenameReplayCallback& Delegate) override;
+	virtual void RenameReplay(const FString& ReplayName, const FString& NewName, const FRenameReplayCallback& Delegate) override;
+	virtual void RenameReplay(const FString& ReplayName, const FString& NewName, const int32 UserIndex, const FRenameReplayCallback& Delegate) override;
+	virtual FString GetReplayID() const override { return ReplayName; }
+	virtual void SetTimeBufferHintSeconds(const float InTimeBufferHintSeconds) override {}
+	virtual void RefreshHeader() override;
+	virtual void DownloadHeader(const FDownloadHeaderCallback& Delegate) override;
+	virtual bool IsCheckpointTypeSupported(EReplayCheckpointType CheckpointType) const override { return CheckpointType == EReplayCheckpointType::Full; }
+	virtual void SetAnalyticsProvider(TSharedPtr<IAnalyticsProvider>& InProvider) override {}
+	virtual bool SetDemoPath(const FString& DemoPath) override { return false; }
+	virtual bool GetDemoPath(FString& DemoPath) const override;
+	virtual uint32 GetMaxFriendlyNameSize() const override { return 0; }
+	virtual ENetworkReplayError::Type GetLastError() const override { return ENetworkReplayError::None; }
+
+	/**
+	 * Where playback looks for a replay, a bare name resolves to Saved/Demos/<Name>.codecksreplay
+	 */
+	static FString GetReplayFilename(const FString& Name);
+
+	static FString GetDemoDirectory();
+
+private:
+	void PushHeader();
+
+	bool LoadPlayback(const FString& Filename);
+
+	/** Jumps the demo driver to the start of the window, nothing before it can be played without its checkpoint */
+	bool GotoWindowStart(float DeltaTime);
+
+	FString ReplayName;
+	bool bRecording = false;
+	bool bStreaming = false;
+
+	uint32 TotalDemoTimeMS = 0;
+
+	// Recording
+	TArray<uint8> HeaderBuffer;
+	FMemoryWriter HeaderWriter { HeaderBuffer };
+	int32 PushedHeaderSize = 0;
+
+	FCodecksReplayStreamArchive StreamArchive;
+
+	TArray<uint8> CheckpointBuffer;
+	FMemoryWriter CheckpointWriter { CheckpointBuffer };
+
+	// Playback
+	FCodecksReplaySnapshot Playback;
+
+	FMemoryReader HeaderReader { Playback.Header };
+
+	TArray<uint8> PlaybackStream;
+	FMemoryReader StreamReader { PlaybackStream };
+
+	// Where each segment of Playback starts in PlaybackStream
+	TArray<int64> SegmentOffsets;
+
+	TArray<uint8> PlaybackCheckpoint;
+	FMemoryReader CheckpointReader { PlaybackCheckpoint };
+
+	bool bAwaitingWindowStart = false;
+	FTSTicker::FDelegateHandle WindowStartHandle;
+};
@@ -0,0 +1,14 @@
+// Copyright(C) battyRabbit UG (limited liability). All Rights Reserved.
+
+#include "CodecksReplayStreaming.h"
+
+#include "CodecksReplayStreamer.h"
+
+DEFINE_LOG_CATEGORY(LogCodecksReplayStreaming);
+
+TSharedPtr<INetworkReplayStreamer> FCodecksReplayStreamingModule::CreateReplayStreamer()
+{
+	return MakeShared<FCodecksReplayStreamer>();
+}
+
+IMPLEMENT_MODULE(FCodecksReplayStreamingModule, CodecksReplayStreaming)
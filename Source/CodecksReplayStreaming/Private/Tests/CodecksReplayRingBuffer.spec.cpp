@@ -0,0 +1,147 @@
+// Copyright(C) battyRabbit UG (limited liability). All Rights Reserved.
+
+#include <CoreMinimal.h>
+
+#include "CodecksReplayRingBuffer.h"
+
+#include <HAL/PlatformTime.h>
+
+BEGIN_DEFINE_SPEC(FCodecksReplayRingBufferSpec, "CodecksUnreal.ReplayRingBuffer", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+	TUniquePtr<FCodecksReplayRingBuffer> RingBuffer;
+
+	// Roughly what a busy 16 player match streams: 60 frames a second, 2KB each, a 256KB checkpoint every 10 seconds
+	static constexpr int32 FramesPerSecond = 60;
+	static constexpr int32 FrameSize = 2 * 1024;
+	static constexpr uint32 CheckpointIntervalMS = 10 * 1000;
+	static constexpr int32 CheckpointSize = 256 * 1024;
+
+	// Production budget is 10 us per frame, five times that leaves room for shared test machines and debug builds
+	static constexpr double MaxMicrosecondsPerFrame = 50.0;
+
+	/** Records the given minutes of match and returns the average time spent per frame in microseconds */
+	double Record(int32 Minutes, int64& OutPeakAllocatedSize)
+	{
+		TArray<uint8> Frame;
+		Frame.SetNumUninitialized(FrameSize);
+
+		OutPeakAllocatedSize = 0;
+		double RecordingSeconds = 0.0;
+
+		const int32 NumFrames = Minutes * 60 * FramesPerSecond;
+		for (int32 FrameIndex = 0; FrameIndex < NumFrames; ++FrameIndex)
+		{
+			const uint32 TimeMS = static_cast<uint32>(FrameIndex * 1000 / FramesPerSecond);
+
+			// The demo driver serializes the checkpoint itself, only handing it over counts towards the overhead
+			const bool bCheckpoint = FrameIndex > 0 && TimeMS % CheckpointIntervalMS < 1000 / FramesPerSecond;
+			TArray<uint8> Checkpoint;
+			if (bCheckpoint)
+			{
+				Checkpoint.SetNumUninitialized(CheckpointSize);
+			}
+
+			const double StartTime = FPlatformTime::Seconds();
+			if (bCheckpoint)
+			{
+				RingBuffer->AddCheckpoint(MoveTemp(Checkpoint), TimeMS);
+			}
+			RingBuffer->AppendStream(Frame.GetData(), Frame.Num(), TimeMS);
+			RecordingSeconds += FPlatformTime::Seconds() - StartTime;
+
+			OutPeakAllocatedSize = FMath::Max(OutPeakAllocatedSize, RingBuffer->GetAllocatedSize());
+		}
+
+		return RecordingSeconds * 1000000.0 / NumFrames;
+	}
+END_DEFINE_SPEC(FCodecksReplayRingBufferSpec)
+
+void FCodecksReplayRingBufferSpec::Define()
+{
+	BeforeEach([this]
+	{
+		RingBuffer = MakeUnique<FCodecksReplayRingBuffer>();
+		RingBuffer->Configure(60.0f, 32 * 1024 * 1024);
+		RingBuffer->SetHeader({1, 2, 3, 4});
+	});
+
+	Describe("Window", [this]()
+	{
+		It("Keeps the last seconds starting at a checkpoint", [this]()
+		{
+			int64 PeakAllocatedSize = 0;
+			Record(3, PeakAllocatedSize);
+
+			const FCodecksReplaySnapshot Snapshot = RingBuffer->Snapshot();
+			if (!TestFalse("Snapshot is empty", Snapshot.IsEmpty()))
+			{
+				return;
+			}
+
+			const uint32 EndTimeMS = Snapshot.Segments.Last()->EndTimeMS;
+			TestTrue("Window starts at a checkpoint", Snapshot.Segments[0]->bHasCheckpoint);
+			TestTrue("Window covers the configured time", Snapshot.Segments[0]->StartTimeMS <= EndTimeMS - 60 * 1000);
+			TestTrue("Window ends within a checkpoint interval of it", Snapshot.Segments[0]->StartTimeMS > EndTimeMS - 60 * 1000 - CheckpointIntervalMS);
+		});
+
+		It("Drops old segments to stay below the memory cap", [this]()
+		{
+			RingBuffer->Configure(600.0f, 4 * 1024 * 1024);
+
+			int64 PeakAllocatedSize = 0;
+			Record(3, PeakAllocatedSize);
+
+			TestTrue("Peak memory stays below the cap", PeakAllocatedSize <= 4 * 1024 * 1024);
+			TestFalse("Snapshot is empty", RingBuffer->Snapshot().IsEmpty());
+		});
+
+		It("Survives a save and load", [this]()
+		{
+			int64 PeakAllocatedSize = 0;
+			Record(1, PeakAllocatedSize);
+
+			const FCodecksReplaySnapshot Snapshot = RingBuffer->Snapshot();
+
+			TArray64<uint8> Saved;
+			if (!TestTrue("Saved", Snapshot.Save(Saved)))
+			{
+				return;
+			}
+
+			FCodecksReplaySnapshot Loaded;
+			if (!TestTrue("Loaded", Loaded.Load(TArray<uint8>(Saved.GetData(), static_cast<int32>(Saved.Num())))))
+			{
+				return;
+			}
+
+			TestTrue("Header", Loaded.Header == Snapshot.Header);
+			if (TestEqual("Segments", Loaded.Segments.Num(), Snapshot.Segments.Num()))
+			{
+				for (int32 SegmentIndex = 0; SegmentIndex < Loaded.Segments.Num(); ++SegmentIndex)
+				{
+					TestEqual("Start time", int64(Loaded.Segments[SegmentIndex]->StartTimeMS), int64(Snapshot.Segments[SegmentIndex]->StartTimeMS));
+					TestTrue("Stream", Loaded.Segments[SegmentIndex]->Stream == Snapshot.Segments[SegmentIndex]->Stream);
+				}
+			}
+		});
+	});
+
+	Describe("Benchmark", [this]()
+	{
+		It("Ring buffer overhead over a long match", [this]()
+		{
+			int64 PeakAllocatedSize = 0;
+			const double MicrosecondsPerFrame = Record(20, PeakAllocatedSize);
+
+			// Only the ring buffer's share, replication cost of the demo driver is measured by the ReplayStreamer benchmark
+			AddInfo(FString::Printf(TEXT("Ring buffer costs %.2f us per frame, peak memory %.1f MB"), MicrosecondsPerFrame, PeakAllocatedSize / (1024.0 * 1024.0)));
+
+			TestTrue("Peak memory stays below the cap", PeakAllocatedSize <= RingBuffer->GetMaxBytes());
+			TestTrue(FString::Printf(TEXT("Stays within %.0f us per frame"), MaxMicrosecondsPerFrame), MicrosecondsPerFrame <= MaxMicrosecondsPerFrame);
+		});
+	});
+
+	AfterEach([this]
+	{
+		RingBuffer.Reset();
+	});
+}
@@ -0,0 +1,133 @@
+// Copyright(C) battyRabbit UG (limited liability). All Rights Reserved.
+
+#include <CoreMinimal.h>
+
+#include "CodecksReplayRingBuffer.h"
+
+#include <Components/StaticMeshComponent.h>
+#include <Engine/DemoNetDriver.h>
+#include <Engine/Engine.h>
+#include <Engine/StaticMeshActor.h>
+#include <Engine/World.h>
+#include <GameFramework/WorldSettings.h>
+#include <HAL/PlatformTime.h>
+
+BEGIN_DEFINE_SPEC(FCodecksReplayStreamerSpec, "CodecksUnreal.ReplayStreamer", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+	UWorld* World = nullptr;
+	TArray<AActor*> Actors;
+
+	// A crowded match: a few hundred replicated actors moving every frame at 60 fps
+	static constexpr int32 NumActors = 256;
+	static constexpr int32 NumFrames = 60 * 30;
+	static constexpr float DeltaSeconds = 1.0f / 60.0f;
+
+	// Production budget is 1 ms per frame for recording such a match, four times that leaves room for shared test machines and debug builds
+	static constexpr double MaxOverheadMicroseconds = 4000.0;
+
+	bool StartRecording()
+	{
+		if (!GEngine->CreateNamedNetDriver(World, NAME_DemoNetDriver, NAME_DemoNetDriver))
+		{
+			return false;
+		}
+
+		UDemoNetDriver* DemoNetDriver = Cast<UDemoNetDriver>(GEngine->FindNamedNetDriver(World, NAME_DemoNetDriver));
+		if (!DemoNetDriver)
+		{
+			return false;
+		}
+
+		World->SetDemoNetDriver(DemoNetDriver);
+		DemoNetDriver->SetWorld(World);
+
+		// Same streamer the report recorder selects
+		FURL DemoURL;
+		DemoURL.Map = TEXT("CodecksReplayBenchmark");
+		DemoURL.AddOption(TEXT("ReplayStreamerOverride=CodecksReplayStreaming"));
+
+		FString Error;
+		return DemoNetDriver->InitListen(World, DemoURL, false, Error);
+	}
+
+	/** Ticks the world moving every actor and returns the average time per frame in microseconds */
+	double TickFrames()
+	{
+		double TickSeconds = 0.0;
+		for (int32 FrameIndex = 0; FrameIndex < NumFrames; ++FrameIndex)
+		{
+			for (int32 ActorIndex = 0; ActorIndex < Actors.Num(); ++ActorIndex)
+			{
+				const float Angle = (FrameIndex + ActorIndex) * DeltaSeconds;
+				Actors[ActorIndex]->SetActorLocation(FVector(ActorIndex * 100.0f + FMath::Cos(Angle) * 50.0f, FMath::Sin(Angle) * 50.0f, 0.0f));
+			}
+
+			const double StartTime = FPlatformTime::Seconds();
+			World->Tick(LEVELTICK_All, DeltaSeconds);
+			TickSeconds += FPlatformTime::Seconds() - StartTime;
+		}
+
+		return TickSeconds * 1000000.0 / NumFrames;
+	}
+END_DEFINE_SPEC(FCodecksReplayStreamerSpec)
+
+void FCodecksReplayStreamerSpec::Define()
+{
+	Describe("Benchmark", [this]()
+	{
+		BeforeEach([this]
+		{
+			FCodecksReplayRingBuffer::Get().Configure(60.0f, 32 * 1024 * 1024);
+
+			World = UWorld::CreateWorld(EWorldType::Game, /*bInformEngineOfWorld=*/false, TEXT("CodecksReplayBenchmark"));
+			FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+			WorldContext.SetCurrentWorld(World);
+
+			World->InitializeActorsForPlay(FURL());
+			World->BeginPlay();
+			World->GetWorldSettings()->NotifyBeginPlay();
+
+			for (int32 ActorIndex = 0; ActorIndex < NumActors; ++ActorIndex)
+			{
+				AStaticMeshActor* Actor = World->SpawnActor<AStaticMeshActor>();
+				Actor->GetStaticMeshComponent()->SetMobility(EComponentMobility::Movable);
+				Actor->SetReplicates(true);
+				Actor->SetReplicateMovement(true);
+				Actors.Add(Actor);
+			}
+		});
+
+		It("World tick with and without recording", [this]()
+		{
+			// Warm up first, so neither run pays for first time allocations
+			TickFrames();
+			const double WithoutRecording = TickFrames();
+
+			if (!TestTrue("Recording started", StartRecording()))
+			{
+				return;
+			}
+
+			const double WithRecording = TickFrames();
+			const int64 AllocatedSize = FCodecksReplayRingBuffer::Get().GetAllocatedSize();
+
+			AddInfo(FString::Printf(TEXT("%d actors, world tick %.1f us without recording, %.1f us with recording (%.1f us per frame), ring buffer %.1f MB"),
+				NumActors, WithoutRecording, WithRecording, WithRecording - WithoutRecording, AllocatedSize / (1024.0 * 1024.0)));
+
+			TestTrue("Recorded into the ring buffer", AllocatedSize > 0);
+			TestTrue("Ring buffer stays below the cap", AllocatedSize <= FCodecksReplayRingBuffer::Get().GetMaxBytes());
+			TestTrue(FString::Printf(TEXT("Recording stays within %.0f us per frame"), MaxOverheadMicroseconds), WithRecording - WithoutRecording <= MaxOverheadMicroseconds);
+		});
+
+		AfterEach([this]
+		{
+			Actors.Reset();
+
+			World->DestroyDemoNetDriver();
+			GEngine->DestroyWorldContext(World);
+			World->DestroyWorld(/*bInformEngineOfWorld=*/false);
+			World = nullptr;
+
+			FCodecksReplayRingBuffer::Get().Reset();
+		});
+	});
+}
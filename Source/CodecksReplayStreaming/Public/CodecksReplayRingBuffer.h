@@ -0,0 +1,99 @@
+// Copyright(C) battyRabbit UG (limited liability). All Rights Reserved.
+
+#pragma once
+
+#include <CoreMinimal.h>
+
+#include <HAL/CriticalSection.h>
+
+/**
+ * Replay data between two checkpoints: the checkpoint it starts with and the stream recorded after it.
+ * The very first segment of a recording has no checkpoint, it starts at the beginning of the stream.
+ * Segments are immutable once the next checkpoint closed them, so snapshots can share them.
+ */
+struct FCodecksReplaySegment
+{
+	uint32 StartTimeMS = 0;
+	uint32 EndTimeMS = 0;
+
+	bool bHasCheckpoint = false;
+	TArray<uint8> Checkpoint;
+	TArray<uint8> Stream;
+
+	int64 GetAllocatedSize() const { return Checkpoint.GetAllocatedSize() + Stream.GetAllocatedSize(); }
+};
+
+using FCodecksReplaySegmentRef = TSharedRef<const FCodecksReplaySegment, ESPMode::ThreadSafe>;
+
+/**
+ * Everything needed to play back the recorded window: the replay header and the segments in order.
+ */
+struct CODECKSREPLAYSTREAMING_API FCodecksReplaySnapshot
+{
+	TArray<uint8> Header;
+	TArray<FCodecksReplaySegmentRef> Segments;
+
+	bool IsEmpty() const { return Segments.Num() == 0; }
+
+	/**
+	 * Serializes into the compressed .codecksreplay container. Meant to run on a worker thread.
+	 */
+	bool Save(TArray64<uint8>& OutCompressed) const;
+
+	/**
+	 * Reads a .codecksreplay container, @see Save
+	 */
+	bool Load(const TArray<uint8>& Compressed);
+};
+
+/**
+ * Keeps the last seconds of the current replay recording in memory, bounded by time and by a fixed memory cap.
+ *
+ * Eviction works on whole segments, as playback can only resume at a checkpoint. The checkpoint interval of the
+ * demo driver therefore sets the granularity, the window always covers at least the configured time.
+ */
+class CODECKSREPLAYSTREAMING_API FCodecksReplayRingBuffer
+{
+public:
+	static FCodecksReplayRingBuffer& Get();
+
+	/**
+	 * @param InMaxSeconds Time window to keep, older segments are dropped
+	 * @param InMaxBytes Memory cap, older segments are dropped beyond it even if still inside the window
+	 */
+	void Configure(float InMaxSeconds, int64 InMaxBytes);
+
+	/** Drops everything recorded so far, to be called when a new recording starts */
+	void Reset();
+
+	void SetHeader(TArray<uint8>&& InHeader);
+	void AppendStream(const uint8* Data, int64 Num, uint32 TimeMS);
+	void AddCheckpoint(TArray<uint8>&& Checkpoint, uint32 TimeMS);
+
+	/**
+	 * Shares the closed segments and copies the one still being recorded, cheap enough for the game thread.
+	 */
+	FCodecksReplaySnapshot Snapshot() const;
+
+	int64 GetAllocatedSize() const;
+	float GetMaxSeconds() const { return MaxSeconds; }
+	int64 GetMaxBytes() const { return MaxBytes; }
+
+private:
+	void Evict();
+
+	mutable FCriticalSection Mutex;
+
+	float MaxSeconds = 60.0f;
+	int64 MaxBytes = 32 * 1024 * 1024;
+
+	TArray<uint8> Header;
+	TArray<FCodecksReplaySegmentRef> ClosedSegments;
+	int64 ClosedSegmentsSize = 0;
+
+	// Segment currently being recorded into, only closed by the next checkpoint
+	FCodecksReplaySegment OpenSegment;
+
+	// Set when the open segment alone outgrew the cap, the stream is unplayable until the next checkpoint
+	bool bWaitingForCheckpoint = false;
+};
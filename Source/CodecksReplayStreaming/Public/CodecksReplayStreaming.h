@@ -0,0 +1,20 @@
+// Copyright(C) battyRabbit UG (limited liability). All Rights Reserved.
+
+#pragma once
+
+#include <CoreMinimal.h>
+
+#include <NetworkReplayStreaming.h>
+
+/**
+ * Replay streamer factory, selected with the ReplayStreamerOverride=CodecksReplayStreaming url option.
+ * Recordings go into FCodecksReplayRingBuffer, playback reads .codecksreplay files from Saved/Demos.
+ */
+class FCodecksReplayStreamingModule : public INetworkReplayStreamingFactory
+{
+public:
+	/** INetworkReplayStreamingFactory implementation */
+	virtual TSharedPtr<INetworkReplayStreamer> CreateReplayStreamer() override;
+};
+
+DECLARE_LOG_CATEGORY_EXTERN(LogCodecksReplayStreaming, Log, All);
@@ -45,6 +45,9 @@ public class CodecksUnreal : ModuleRules
 				"SlateCore",
 				"DeveloperSettings",
 				"HTTP",
+				"Projects",
+				"CodecksReplayStreaming",
+				"Sockets",
 				// ... add private dependencies that you statically link with here ...
 			}
 		);
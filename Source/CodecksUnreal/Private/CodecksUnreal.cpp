@@ -2,6 +2,18 @@
 
 #include "CodecksUnreal.h"
 
+#include "Diagnostics/CodecksSystemMetadata.h"
+#include "Memory/CodecksBufferPool.h"
+#include "Network/CodecksBandwidthLimiter.h"
+#include "Network/CodecksConnectionPrewarmer.h"
+#include "Requests/CodecksAttachmentCache.h"
+#include "Settings/CodecksSettings.h"
+
+#include <Engine/Engine.h>
+#include <Engine/NetConnection.h>
+#include <Engine/NetDriver.h>
+#include <Engine/World.h>
+
 DEFINE_LOG_CATEGORY(LogCodecksUnreal);
 
 #define LOCTEXT_NAMESPACE "FCodecksUnrealModule"
@@ -9,12 +21,98 @@ DEFINE_LOG_CATEGORY(LogCodecksUnreal);
 void FCodecksUnrealModule::StartupModule()
 {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
+	GetDefault<UCodecksSettings>()->ApplyUploadBandwidth();
+	FCodecksBufferPool::Get().SetBudget(static_cast<int64>(GetDefault<UCodecksSettings>()->GetBufferPoolBudget()) * 1024 * 1024);
+	FCodecksAttachmentCache::Get().SetBudget(static_cast<int64>(GetDefault<UCodecksSettings>()->GetAttachmentCacheBudget()) * 1024 * 1024);
+
+	if (GetDefault<UCodecksSettings>()->ShouldAttachSystemMetadata())
+	{
+		FCodecksSystemMetadata::Get().GatherAsync(GetDefault<UCodecksSettings>()->ShouldAttachCommandLine());
+	}
+
+	// Hitches in the editor are none of the game's business
+	if (GetDefault<UCodecksSettings>()->IsPerformanceWatchdogEnabled() && !GIsEditor && !IsRunningCommandlet())
+	{
+		PerformanceWatchdog = MakeUnique<FCodecksPerformanceWatchdog>(GetDefault<UCodecksSettings>()->GetPerformanceWatchdogConfig());
+	}
+
+	if (GetDefault<UCodecksSettings>()->IsLowMemoryReportEnabled() && !GIsEditor && !IsRunningCommandlet())
+	{
+		LowMemoryReporter = MakeUnique<FCodecksLowMemoryReporter>(GetDefault<UCodecksSettings>()->GetLowMemoryReportConfig());
+	}
+
+	if (GetDefault<UCodecksSettings>()->ShouldRecordReplayForReports() && !GIsEditor && !IsRunningCommandlet())
+	{
+		ReplayRecorder = MakeUnique<FCodecksReplayRecorder>(GetDefault<UCodecksSettings>()->GetReplayRecorderConfig());
+	}
+
+	if (GetDefault<UCodecksSettings>()->ShouldPrewarmConnectionsOnStartup())
+	{
+		FCodecksConnectionPrewarmer::Get().Prewarm();
+	}
+
+	// Sampling twice a second is plenty to follow congestion, the limiter itself smooths the rest
+	NetworkSampleHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FCodecksUnrealModule::SampleNetworkConditions), 0.5f);
 }
 
 void FCodecksUnrealModule::ShutdownModule()
 {
 	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
 	// we call this function before unloading the module.
+	PerformanceWatchdog.Reset();
+	LowMemoryReporter.Reset();
+	ReplayRecorder.Reset();
+
+	FCodecksBufferPool::Get().Trim();
+	FCodecksAttachmentCache::Get().Trim();
+
+	FTSTicker::GetCoreTicker().RemoveTicker(NetworkSampleHandle);
+	NetworkSampleHandle.Reset();
+}
+
+bool FCodecksUnrealModule::SampleNetworkConditions(float /*DeltaTime*/)
+{
+	FCodecksBandwidthLimiter& Limiter = FCodecksBandwidthLimiter::Get();
+	if (!Limiter.IsAdaptive() || !GEngine)
+	{
+		return true;
+	}
+
+	// Use the worst connection we have, that is the one the player will notice first
+	float WorstLatency = -1.0f;
+	float WorstPacketLoss = 0.0f;
+
+	auto SampleConnection = [&WorstLatency, &WorstPacketLoss](const UNetConnection* Connection) {
+		if (Connection && Connection->GetConnectionState() == USOCK_Open)
+		{
+			WorstLatency = FMath::Max(WorstLatency, Connection->AvgLag);
+			WorstPacketLoss = FMath::Max(WorstPacketLoss, Connection->GetOutLossPercentage().GetAvgLossPercentage());
+		}
+	};
+
+	for (const FWorldContext& WorldContext : GEngine->GetWorldContexts())
+	{
+		const UWorld* World = WorldContext.World();
+		const UNetDriver* NetDriver = World ? World->GetNetDriver() : nullptr;
+		if (!NetDriver)
+		{
+			continue;
+		}
+
+		SampleConnection(NetDriver->ServerConnection);
+		for (const UNetConnection* ClientConnection : NetDriver->ClientConnections)
+		{
+			SampleConnection(ClientConnection);
+		}
+	}
+
+	// Not connected to anything, nothing to protect
+	if (WorstLatency >= 0.0f)
+	{
+		Limiter.ReportNetworkConditions(WorstLatency, WorstPacketLoss);
+	}
+
+	return true;
 }
 
 #undef LOCTEXT_NAMESPACE
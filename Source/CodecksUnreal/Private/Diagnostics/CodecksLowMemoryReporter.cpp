@@ -0,0 +1,302 @@
+// Copyright(C) battyRabbit UG (limited liability). All Rights Reserved.
+
+#include "Diagnostics/CodecksLowMemoryReporter.h"
+
+#include "CodecksUnreal.h"
+#include "Requests/CodecksUserReportRequest.h"
+
+#include <ContentStreaming.h>
+#include <Engine/Engine.h>
+#include <Engine/LevelStreaming.h>
+#include <Engine/World.h>
+#include <HAL/LowLevelMemTracker.h>
+#include <HAL/PlatformMemory.h>
+#include <Misc/App.h>
+#include <Misc/Compression.h>
+#include <Misc/CoreDelegates.h>
+#include <UObject/UObjectGlobals.h>
+#include <UObject/UObjectIterator.h>
+
+namespace CodecksLowMemoryReporter
+{
+	// Free memory is only polled this often, querying it isn't free on every platform
+	constexpr float PollSeconds = 2.0f;
+
+	long long ToKB(uint64 Bytes)
+	{
+		return static_cast<long long>(Bytes / 1024);
+	}
+}
+
+FCodecksLowMemoryReporter::FCodecksLowMemoryReporter(const FConfig& InConfig)
+	: Config(InConfig)
+{
+	// All buffers the snapshot needs are taken now, while there is still memory to take
+	Summary.SetNumZeroed(SummaryCapacity);
+	Compressed.SetNumZeroed(FCompression::CompressMemoryBound(NAME_Gzip, SummaryCapacity));
+	ClassTable.SetNumZeroed(ClassTableSize);
+
+	// Touched so the reserve is actually backed by physical memory
+	TakeReserve(Reserve, Config.ReserveBytes);
+
+	if (!Config.bRegisterHooks)
+	{
+		return;
+	}
+
+	MemoryTrimHandle = FCoreDelegates::GetMemoryTrimDelegate().AddRaw(this, &FCodecksLowMemoryReporter::OnLowMemoryWarning);
+	TickHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FCodecksLowMemoryReporter::Tick), CodecksLowMemoryReporter::PollSeconds);
+}
+
+FCodecksLowMemoryReporter::~FCodecksLowMemoryReporter()
+{
+	FCoreDelegates::GetMemoryTrimDelegate().Remove(MemoryTrimHandle);
+	FTSTicker::GetCoreTicker().RemoveTicker(TickHandle);
+}
+
+void FCodecksLowMemoryReporter::OnLowMemoryWarning()
+{
+	bLowMemoryWarning = true;
+}
+
+bool FCodecksLowMemoryReporter::Tick(float /*DeltaTime*/)
+{
+	bool bShouldReport = bLowMemoryWarning.exchange(false);
+
+	if (!bShouldReport && Config.ThresholdBytes > 0)
+	{
+		bShouldReport = FPlatformMemory::GetStats().AvailablePhysical < Config.ThresholdBytes;
+	}
+
+	if (bShouldReport && FApp::GetCurrentTime() - LastReportTime >= Config.MinSecondsBetweenReports)
+	{
+		LastReportTime = FApp::GetCurrentTime();
+		FileReport();
+	}
+
+	return true;
+}
+
+void FCodecksLowMemoryReporter::FileReport()
+{
+	// Hand the reserve back to the allocator first, the report itself still needs a few small allocations
+	Reserve->Empty();
+
+	WriteSnapshot();
+
+	int32 CompressedSize = Compressed.Num();
+	if (!FCompression::CompressMemory(NAME_Gzip, Compressed.GetData(), CompressedSize, Summary.GetData(), SummaryLength))
+	{
+		UE_LOG(LogCodecksUnreal, Warning, TEXT("Unable to compress low memory snapshot, skipping report..."));
+		TakeReserve(Reserve, Config.ReserveBytes);
+		return;
+	}
+
+	const FPlatformMemoryStats MemoryStats = FPlatformMemory::GetStats();
+
+	UCodecksUserReportRequest* Report = NewObject<UCodecksUserReportRequest>();
+	Report->AddToRoot();
+	Report->SetContent(FString::Printf(TEXT("[Automatic] Low memory warning, %lld MB physical free of %lld MB"),
+		static_cast<long long>(MemoryStats.AvailablePhysical / (1024 * 1024)), static_cast<long long>(MemoryStats.TotalPhysical / (1024 * 1024))));
+	Report->SetSeverity(ECodecksUserReportSeverity::High);
+
+	// Saving the replay window would take tens of MB more right when the OS is about to kill the process,
+	// system-info.json is a copy of a few KB gathered at startup and tells which device ran out
+	Report->SetAttachReplay(false);
+	Report->AttachFile("memory-summary.txt.gz", TArrayView64<uint8>(Compressed.GetData(), CompressedSize), "application/gzip");
+
+	// Succeeded and Failed are both terminal, either way the reserve is taken again for the next warning.
+	// The pressure is either gone by now or the process is.
+	Report->CreateReport([WeakReserve = TWeakPtr<TArray<uint8>>(Reserve), ReserveBytes = Config.ReserveBytes](UCodecksUserReportRequest* Update) {
+		if (Update->GetRequestState() >= ECodecksRequestState::Succeeded)
+		{
+			Update->RemoveFromRoot();
+			TakeReserve(WeakReserve, ReserveBytes);
+		}
+	});
+}
+
+void FCodecksLowMemoryReporter::TakeReserve(const TWeakPtr<TArray<uint8>>& WeakReserve, int32 ReserveBytes)
+{
+	if (const TSharedPtr<TArray<uint8>> PinnedReserve = WeakReserve.Pin())
+	{
+		PinnedReserve->SetNumZeroed(FMath::Max(ReserveBytes, 0));
+	}
+}
+
+int32 FCodecksLowMemoryReporter::WriteSnapshot()
+{
+	SummaryLength = 0;
+
+	WriteMemoryStats();
+	WriteLLMTags();
+	WriteTopClasses();
+	WriteStreamingState();
+
+	return SummaryLength;
+}
+
+void FCodecksLowMemoryReporter::WriteMemoryStats()
+{
+	const FPlatformMemoryStats MemoryStats = FPlatformMemory::GetStats();
+
+	Printf("[memory] (KB)\n");
+	Printf("total_physical=%lld\n", CodecksLowMemoryReporter::ToKB(MemoryStats.TotalPhysical));
+	Printf("available_physical=%lld\n", CodecksLowMemoryReporter::ToKB(MemoryStats.AvailablePhysical));
+	Printf("used_physical=%lld\n", CodecksLowMemoryReporter::ToKB(MemoryStats.UsedPhysical));
+	Printf("peak_used_physical=%lld\n", CodecksLowMemoryReporter::ToKB(MemoryStats.PeakUsedPhysical));
+	Printf("used_virtual=%lld\n", CodecksLowMemoryReporter::ToKB(MemoryStats.UsedVirtual));
+	Printf("peak_used_virtual=%lld\n", CodecksLowMemoryReporter::ToKB(MemoryStats.PeakUsedVirtual));
+}
+
+void FCodecksLowMemoryReporter::WriteLLMTags()
+{
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+	if (!FLowLevelMemTracker::IsEnabled())
+	{
+		return;
+	}
+
+	struct FTag
+	{
+		ELLMTag Tag;
+		const ANSICHAR* Name;
+	};
+
+	static const FTag Tags[] = {
+		{ELLMTag::Total, "Total"},
+		{ELLMTag::Untracked, "Untracked"},
+		{ELLMTag::Textures, "Textures"},
+		{ELLMTag::RenderTargets, "RenderTargets"},
+		{ELLMTag::Meshes, "Meshes"},
+		{ELLMTag::Shaders, "Shaders"},
+		{ELLMTag::Audio, "Audio"},
+		{ELLMTag::Animation, "Animation"},
+		{ELLMTag::Physics, "Physics"},
+		{ELLMTag::UObject, "UObject"},
+		{ELLMTag::AsyncLoading, "AsyncLoading"},
+		{ELLMTag::Networking, "Networking"},
+		{ELLMTag::UI, "UI"},
+		{ELLMTag::FName, "FName"},
+	};
+
+	Printf("\n[llm] (KB)\n");
+	for (const FTag& Tag : Tags)
+	{
+		Printf("%s=%lld\n", Tag.Name, CodecksLowMemoryReporter::ToKB(FLowLevelMemTracker::Get().GetTagAmountForTracker(ELLMTracker::Default, Tag.Tag)));
+	}
+#endif // ENABLE_LOW_LEVEL_MEM_TRACKER
+}
+
+void FCodecksLowMemoryReporter::WriteTopClasses()
+{
+	// Open addressing on the reserved table, shallow object sizes only, resource sizes would need allocations
+	FMemory::Memzero(ClassTable.GetData(), ClassTable.Num() * sizeof(FClassUsage));
+
+	int64 UntrackedCount = 0;
+	for (TObjectIterator<UObject> It; It; ++It)
+	{
+		const UClass* Class = It->GetClass();
+
+		uint32 Slot = PointerHash(Class) & (ClassTableSize - 1);
+		for (int32 Probe = 0; Probe < ClassTableSize && ClassTable[Slot].Class && ClassTable[Slot].Class != Class; ++Probe)
+		{
+			Slot = (Slot + 1) & (ClassTableSize - 1);
+		}
+
+		FClassUsage& Usage = ClassTable[Slot];
+		if (Usage.Class && Usage.Class != Class)
+		{
+			++UntrackedCount;
+			continue;
+		}
+
+		Usage.Class = Class;
+		++Usage.Count;
+		Usage.Bytes += Class->GetStructureSize();
+	}
+
+	Printf("\n[uobject_classes] class=count,KB\n");
+
+	// Selection in place, the table is fixed size and TopClassCount small
+	for (int32 Rank = 0; Rank < TopClassCount; ++Rank)
+	{
+		FClassUsage* Top = nullptr;
+		for (FClassUsage& Usage : ClassTable)
+		{
+			if (Usage.Class && (!Top || Usage.Bytes > Top->Bytes))
+			{
+				Top = &Usage;
+			}
+		}
+
+		if (!Top)
+		{
+			break;
+		}
+
+		ANSICHAR ClassName[NAME_SIZE] = "<wide>";
+		const FNameEntry* NameEntry = Top->Class->GetFName().GetDisplayNameEntry();
+		if (!NameEntry->IsWide())
+		{
+			NameEntry->GetAnsiName(ClassName);
+		}
+
+		Printf("%s=%lld,%lld\n", ClassName, static_cast<long long>(Top->Count), CodecksLowMemoryReporter::ToKB(Top->Bytes));
+		Top->Class = nullptr;
+	}
+
+	if (UntrackedCount > 0)
+	{
+		Printf("<table full>=%lld,0\n", static_cast<long long>(UntrackedCount));
+	}
+}
+
+void FCodecksLowMemoryReporter::WriteStreamingState()
+{
+	Printf("\n[streaming]\n");
+	Printf("async_loading=%d\n", IsAsyncLoading() ? 1 : 0);
+	Printf("async_packages=%d\n", GetNumAsyncPackages());
+	Printf("wanting_resources=%d\n", IStreamingManager::Get().GetNumWantingResources());
+
+	if (!GEngine)
+	{
+		return;
+	}
+
+	for (const FWorldContext& WorldContext : GEngine->GetWorldContexts())
+	{
+		const UWorld* World = WorldContext.World();
+		if (!World || (WorldContext.WorldType != EWorldType::Game && WorldContext.WorldType != EWorldType::PIE))
+		{
+			continue;
+		}
+
+		int32 Loaded = 0;
+		int32 Visible = 0;
+		for (const ULevelStreaming* StreamingLevel : World->GetStreamingLevels())
+		{
+			Loaded += StreamingLevel && StreamingLevel->IsLevelLoaded() ? 1 : 0;
+			Visible += StreamingLevel && StreamingLevel->IsLevelVisible() ? 1 : 0;
+		}
+
+		Printf("streaming_levels=%d,loaded=%d,visible=%d\n", World->GetStreamingLevels().Num(), Loaded, Visible);
+	}
+}
+
+void FCodecksLowMemoryReporter::Printf(const ANSICHAR* Format, ...)
+{
+	const int32 Remaining = SummaryCapacity - SummaryLength;
+	if (Remaining <= 1)
+	{
+		return;
+	}
+
+	va_list Args;
+	va_start(Args, Format);
+	const int32 Written = FCStringAnsi::GetVarArgs(Summary.GetData() + SummaryLength, Remaining, Format, Args);
+	va_end(Args);
+
+	// Truncated output is still better than none, just cut it at the end of the buffer
+	SummaryLength += (Written < 0 || Written >= Remaining) ? Remaining - 1 : Written;
+}
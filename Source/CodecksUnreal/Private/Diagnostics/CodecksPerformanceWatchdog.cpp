@@ -0,0 +1,297 @@
+// Copyright(C) battyRabbit UG (limited liability). All Rights Reserved.
+
+#include "Diagnostics/CodecksPerformanceWatchdog.h"
+
+#include "CodecksUnreal.h"
+#include "Requests/CodecksUserReportRequest.h"
+
+#include <Engine/Engine.h>
+#include <Engine/NetDriver.h>
+#include <Engine/World.h>
+#include <HAL/PlatformStackWalk.h>
+#include <HAL/RunnableThread.h>
+#include <Misc/App.h>
+#include <Misc/CoreDelegates.h>
+#include <Misc/ScopeLock.h>
+#include <UObject/UObjectGlobals.h>
+
+namespace CodecksPerformanceWatchdog
+{
+	// Callstacks taken this many frames before detection still belong to the hitch, frame times are reported a frame late
+	constexpr uint64 CallstackFrameSlack = 2;
+
+	FString GetMapName()
+	{
+		if (GEngine)
+		{
+			for (const FWorldContext& WorldContext : GEngine->GetWorldContexts())
+			{
+				if (WorldContext.WorldType == EWorldType::Game || WorldContext.WorldType == EWorldType::PIE)
+				{
+					if (const UWorld* World = WorldContext.World())
+					{
+						return World->GetMapName();
+					}
+				}
+			}
+		}
+
+		return TEXT("<none>");
+	}
+}
+
+FCodecksPerformanceWatchdog::FCodecksPerformanceWatchdog(const FConfig& InConfig)
+	: Config(InConfig)
+{
+	Config.BudgetWindowFrames = FMath::Clamp(Config.BudgetWindowFrames, 1, WindowSize);
+
+	if (!Config.bRegisterHooks)
+	{
+		return;
+	}
+
+	EndFrameHandle = FCoreDelegates::OnEndFrame.AddRaw(this, &FCodecksPerformanceWatchdog::OnEndFrame);
+	PostLoadMapHandle = FCoreUObjectDelegates::PostLoadMapWithWorld.AddRaw(this, &FCodecksPerformanceWatchdog::OnPostLoadMap);
+
+	WakeEvent = FPlatformProcess::GetSynchEventFromPool();
+	Thread = FRunnableThread::Create(this, TEXT("CodecksPerformanceWatchdog"), 64 * 1024, TPri_BelowNormal);
+}
+
+FCodecksPerformanceWatchdog::~FCodecksPerformanceWatchdog()
+{
+	FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+	FCoreUObjectDelegates::PostLoadMapWithWorld.Remove(PostLoadMapHandle);
+
+	if (Thread)
+	{
+		Thread->Kill(/*bShouldWait=*/true);
+		delete Thread;
+		Thread = nullptr;
+	}
+
+	if (WakeEvent)
+	{
+		FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+		WakeEvent = nullptr;
+	}
+}
+
+ECodecksUserReportSeverity FCodecksPerformanceWatchdog::GetSeverityForOverrun(float Ratio)
+{
+	if (Ratio >= 4.0f)
+	{
+		return ECodecksUserReportSeverity::Critical;
+	}
+
+	if (Ratio >= 2.0f)
+	{
+		return ECodecksUserReportSeverity::High;
+	}
+
+	return ECodecksUserReportSeverity::Low;
+}
+
+uint32 FCodecksPerformanceWatchdog::Run()
+{
+	// Checking twice per threshold catches every hitch while it is still running
+	const uint32 PollMs = FMath::Max(static_cast<uint32>(Config.HitchThresholdMs * 0.5f), 1u);
+
+	uint64 SampledFrame = 0;
+	while (!bStopping)
+	{
+		WakeEvent->Wait(PollMs);
+
+		const uint64 StartCycles = FrameStartCycles.load(std::memory_order_acquire);
+		const uint64 Frame = FrameNumber.load(std::memory_order_acquire);
+		if (StartCycles == 0 || Frame == SampledFrame)
+		{
+			continue;
+		}
+
+		const double RunningMs = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles);
+		if (RunningMs < Config.HitchThresholdMs)
+		{
+			continue;
+		}
+
+		// Still stuck in the same frame, so this is what the game thread is busy with
+		TStaticArray<uint64, MaxCallstackDepth> Sample;
+		const uint32 Depth = FPlatformStackWalk::CaptureThreadStackBackTrace(GGameThreadId, Sample.GetData(), MaxCallstackDepth);
+		SampledFrame = Frame;
+
+		FScopeLock Lock(&CallstackMutex);
+		Callstack = Sample;
+		CallstackDepth = static_cast<int32>(Depth);
+		CallstackFrame = Frame;
+	}
+
+	return 0;
+}
+
+void FCodecksPerformanceWatchdog::Stop()
+{
+	bStopping = true;
+	WakeEvent->Trigger();
+}
+
+void FCodecksPerformanceWatchdog::OnEndFrame()
+{
+	const float WorkMs = static_cast<float>(FMath::Max(FApp::GetDeltaTime() - FApp::GetIdleTime(), 0.0)) * 1000.0f;
+
+	FrameNumber.fetch_add(1, std::memory_order_release);
+	FrameStartCycles.store(FPlatformTime::Cycles64(), std::memory_order_release);
+
+	FDetection Detection;
+	if (RecordFrame(WorkMs, FApp::GetCurrentTime(), Detection))
+	{
+		FileReport(Detection);
+	}
+}
+
+bool FCodecksPerformanceWatchdog::RecordFrame(float WorkMs, double CurrentTime, FDetection& OutDetection)
+{
+	if (RecordedFrames >= Config.BudgetWindowFrames)
+	{
+		BudgetWindowSumMs -= FrameWorkMs[(NextFrame - Config.BudgetWindowFrames + WindowSize) % WindowSize];
+	}
+	BudgetWindowSumMs += WorkMs;
+
+	FrameWorkMs[NextFrame] = WorkMs;
+	NextFrame = (NextFrame + 1) % WindowSize;
+	RecordedFrames = FMath::Min(RecordedFrames + 1, WindowSize);
+
+	if (CurrentTime < IgnoreFramesUntil || !CanReport(CurrentTime))
+	{
+		return false;
+	}
+
+	if (WorkMs > Config.HitchThresholdMs)
+	{
+		OutDetection.Summary = FString::Printf(TEXT("[Automatic] Hitch of %.1f ms on the game thread (threshold %.1f ms) in %s"), WorkMs, Config.HitchThresholdMs, *CodecksPerformanceWatchdog::GetMapName());
+		OutDetection.Ratio = WorkMs / Config.HitchThresholdMs;
+	}
+	else
+	{
+		const float TickBudgetMs = GetTickBudgetMs();
+		const float AverageMs = GetBudgetWindowAverageMs();
+		if (TickBudgetMs <= 0.0f || AverageMs <= TickBudgetMs)
+		{
+			return false;
+		}
+
+		OutDetection.Summary = FString::Printf(TEXT("[Automatic] Tick budget overrun, averaging %.1f ms over %d frames (budget %.1f ms) in %s"), AverageMs, Config.BudgetWindowFrames, TickBudgetMs, *CodecksPerformanceWatchdog::GetMapName());
+		OutDetection.Ratio = AverageMs / TickBudgetMs;
+	}
+
+	++ReportsThisMap;
+	LastReportTime = CurrentTime;
+	return true;
+}
+
+void FCodecksPerformanceWatchdog::BeginMap(double CurrentTime)
+{
+	ReportsThisMap = 0;
+	IgnoreFramesUntil = CurrentTime + Config.MapLoadGraceSeconds;
+}
+
+float FCodecksPerformanceWatchdog::GetBudgetWindowAverageMs() const
+{
+	return RecordedFrames >= Config.BudgetWindowFrames ? static_cast<float>(BudgetWindowSumMs / Config.BudgetWindowFrames) : 0.0f;
+}
+
+void FCodecksPerformanceWatchdog::OnPostLoadMap(UWorld* /*LoadedWorld*/)
+{
+	BeginMap(FApp::GetCurrentTime());
+}
+
+float FCodecksPerformanceWatchdog::GetTickBudgetMs() const
+{
+	if (Config.TickBudgetMs > 0.0f)
+	{
+		return Config.TickBudgetMs;
+	}
+
+	// Only servers have a fixed budget to derive, clients render as fast as they can
+	if (GEngine)
+	{
+		for (const FWorldContext& WorldContext : GEngine->GetWorldContexts())
+		{
+			const UWorld* World = WorldContext.World();
+			const UNetDriver* NetDriver = World ? World->GetNetDriver() : nullptr;
+			if (NetDriver && NetDriver->IsServer() && NetDriver->GetNetServerMaxTickRate() > 0)
+			{
+				return 1000.0f / NetDriver->GetNetServerMaxTickRate();
+			}
+		}
+	}
+
+	return 0.0f;
+}
+
+bool FCodecksPerformanceWatchdog::CanReport(double CurrentTime) const
+{
+	return ReportsThisMap < Config.MaxReportsPerMap && CurrentTime - LastReportTime >= Config.MinSecondsBetweenReports;
+}
+
+void FCodecksPerformanceWatchdog::FileReport(const FDetection& Detection)
+{
+	UE_LOG(LogCodecksUnreal, Log, TEXT("%s, filing report..."), *Detection.Summary);
+
+	// Copy out the stats window oldest frame first, formatting happens only once the report was accepted
+	TArray<float> Window;
+	Window.Reserve(RecordedFrames);
+	for (int32 Frame = RecordedFrames; Frame > 0; --Frame)
+	{
+		Window.Add(FrameWorkMs[(NextFrame - Frame + WindowSize) % WindowSize]);
+	}
+
+	TArray<uint64> Backtrace;
+	{
+		FScopeLock Lock(&CallstackMutex);
+		if (CallstackDepth > 0 && FrameNumber.load(std::memory_order_relaxed) - CallstackFrame <= CodecksPerformanceWatchdog::CallstackFrameSlack)
+		{
+			Backtrace.Append(Callstack.GetData(), CallstackDepth);
+		}
+	}
+
+	UCodecksUserReportRequest* Report = NewObject<UCodecksUserReportRequest>();
+	Report->AddToRoot();
+	Report->SetContent(Detection.Summary);
+	Report->SetSeverity(GetSeverityForOverrun(Detection.Ratio));
+
+	Report->AttachLazy("frame-times.csv", [Window = MoveTemp(Window)](TArray64<uint8>& OutBinary, FString& OutContentType) {
+		FString Csv = TEXT("frame,game_thread_ms\n");
+		for (int32 Frame = 0; Frame < Window.Num(); ++Frame)
+		{
+			Csv += FString::Printf(TEXT("%d,%.3f\n"), Frame - Window.Num() + 1, Window[Frame]);
+		}
+
+		const FTCHARToUTF8 Utf8Csv(*Csv);
+		OutBinary.Append(reinterpret_cast<const uint8*>(Utf8Csv.Get()), Utf8Csv.Length());
+		OutContentType = "text/csv";
+		return true;
+	});
+
+	if (Backtrace.Num() > 0)
+	{
+		Report->AttachLazy("callstack.txt", [Backtrace = MoveTemp(Backtrace)](TArray64<uint8>& OutBinary, FString& OutContentType) {
+			for (int32 Depth = 0; Depth < Backtrace.Num(); ++Depth)
+			{
+				ANSICHAR Line[1024] = {};
+				FPlatformStackWalk::ProgramCounterToHumanReadableString(Depth, Backtrace[Depth], Line, UE_ARRAY_COUNT(Line));
+				FCStringAnsi::Strncat(Line, "\n", UE_ARRAY_COUNT(Line));
+				OutBinary.Append(reinterpret_cast<const uint8*>(Line), FCStringAnsi::Strlen(Line));
+			}
+
+			OutContentType = "text/plain";
+			return true;
+		});
+	}
+
+	Report->CreateReport([](UCodecksUserReportRequest* Update) {
+		if (Update->GetRequestState() >= ECodecksRequestState::Succeeded)
+		{
+			Update->RemoveFromRoot();
+		}
+	});
+}
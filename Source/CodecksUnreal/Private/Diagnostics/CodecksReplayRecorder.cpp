@@ -0,0 +1,84 @@
+// Copyright(C) battyRabbit UG (limited liability). All Rights Reserved.
+
+#include "Diagnostics/CodecksReplayRecorder.h"
+
+#include "CodecksReplayRingBuffer.h"
+#include "CodecksUnreal.h"
+
+#include <Engine/DemoNetDriver.h>
+#include <Engine/GameInstance.h>
+#include <Engine/World.h>
+#include <HAL/IConsoleManager.h>
+#include <UObject/UObjectGlobals.h>
+
+namespace CodecksReplayRecorder
+{
+	constexpr TCHAR ReplayName[] = TEXT("CodecksReport");
+
+	constexpr TCHAR CheckpointIntervalVariable[] = TEXT("demo.CheckpointUploadDelayInSeconds");
+
+	// Downloaded replays go to Saved/Demos, from where this plays them with the codecks streamer
+	FAutoConsoleCommandWithWorldAndArgs PlayReplayCommand(
+		TEXT("Codecks.PlayReplay"),
+		TEXT("Plays a replay attached to a codecks report. Usage: Codecks.PlayReplay <file in Saved/Demos>"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World) {
+			UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+			if (Args.Num() == 0 || !GameInstance)
+			{
+				UE_LOG(LogCodecksUnreal, Warning, TEXT("Usage: Codecks.PlayReplay <file in Saved/Demos>"));
+				return;
+			}
+
+			GameInstance->PlayReplay(Args[0], nullptr, {FCodecksReplayRecorder::StreamerOverrideOption});
+		}));
+}
+
+const FString FCodecksReplayRecorder::StreamerOverrideOption = TEXT("ReplayStreamerOverride=CodecksReplayStreaming");
+
+FCodecksReplayRecorder::FCodecksReplayRecorder(const FConfig& InConfig)
+{
+	FCodecksReplayRingBuffer::Get().Configure(InConfig.BufferSeconds, InConfig.MemoryCapBytes);
+
+	// The demo driver has no url option for it, so this affects every replay recorded meanwhile, not just ours
+	if (InConfig.CheckpointInterval > 0.0f)
+	{
+		if (IConsoleVariable* CheckpointDelay = IConsoleManager::Get().FindConsoleVariable(CodecksReplayRecorder::CheckpointIntervalVariable))
+		{
+			PreviousCheckpointInterval = CheckpointDelay->GetFloat();
+			CheckpointDelay->Set(InConfig.CheckpointInterval, ECVF_SetByCode);
+		}
+	}
+
+	PostLoadMapHandle = FCoreUObjectDelegates::PostLoadMapWithWorld.AddRaw(this, &FCodecksReplayRecorder::OnPostLoadMap);
+}
+
+FCodecksReplayRecorder::~FCodecksReplayRecorder()
+{
+	FCoreUObjectDelegates::PostLoadMapWithWorld.Remove(PostLoadMapHandle);
+
+	if (PreviousCheckpointInterval >= 0.0f)
+	{
+		if (IConsoleVariable* CheckpointDelay = IConsoleManager::Get().FindConsoleVariable(CodecksReplayRecorder::CheckpointIntervalVariable))
+		{
+			CheckpointDelay->Set(PreviousCheckpointInterval, ECVF_SetByCode);
+		}
+	}
+}
+
+void FCodecksReplayRecorder::OnPostLoadMap(UWorld* LoadedWorld)
+{
+	if (!LoadedWorld || !LoadedWorld->IsGameWorld() || LoadedWorld->IsPlayingReplay())
+	{
+		return;
+	}
+
+	UGameInstance* GameInstance = LoadedWorld->GetGameInstance();
+	const UDemoNetDriver* DemoNetDriver = LoadedWorld->GetDemoNetDriver();
+	if (!GameInstance || (DemoNetDriver && DemoNetDriver->IsRecording()))
+	{
+		return;
+	}
+
+	// Every map starts a new recording, the window never spans a map change
+	GameInstance->StartRecordingReplay(CodecksReplayRecorder::ReplayName, CodecksReplayRecorder::ReplayName, {StreamerOverrideOption});
+}
@@ -0,0 +1,117 @@
+// Copyright(C) battyRabbit UG (limited liability). All Rights Reserved.
+
+#include "Diagnostics/CodecksSystemMetadata.h"
+
+#include <BuildSettings.h>
+#include <GenericPlatform/GenericPlatformMisc.h>
+#include <HAL/PlatformMemory.h>
+#include <HAL/PlatformMisc.h>
+#include <HAL/PlatformProperties.h>
+#include <Interfaces/IPluginManager.h>
+#include <Misc/App.h>
+#include <Misc/CommandLine.h>
+#include <Misc/EngineVersion.h>
+#include <Misc/ScopeLock.h>
+#include <Policies/PrettyJsonPrintPolicy.h>
+#include <Serialization/JsonWriter.h>
+
+FCodecksSystemMetadata& FCodecksSystemMetadata::Get()
+{
+	static FCodecksSystemMetadata Metadata;
+	return Metadata;
+}
+
+void FCodecksSystemMetadata::GatherAsync(bool bIncludeCommandLine)
+{
+	check(IsInGameThread());
+
+	// Plugins are still being mounted on the game thread, so list them here, it is just a few names
+	TArray<FString> EnabledPlugins;
+	for (const TSharedRef<IPlugin>& Plugin : IPluginManager::Get().GetEnabledPlugins())
+	{
+		EnabledPlugins.Add(Plugin->GetName() + TEXT(" ") + Plugin->GetDescriptor().VersionName);
+	}
+	EnabledPlugins.Sort();
+
+	// Some of these are slow (GPU and OS queries), that's why they never run on the report path
+	GatherTask = UE::Tasks::Launch(TEXT("Codecks_GatherSystemMetadata"), [EnabledPlugins = MoveTemp(EnabledPlugins), bIncludeCommandLine]() mutable {
+		const FPlatformMemoryConstants& MemoryConstants = FPlatformMemory::GetConstants();
+
+		FGatheredMetadata Gathered;
+		Gathered.Fields = {
+			{TEXT("project"), FApp::GetProjectName()},
+			{TEXT("buildVersion"), FApp::GetBuildVersion()},
+			{TEXT("buildConfiguration"), LexToString(FApp::GetBuildConfiguration())},
+			{TEXT("engineVersion"), FEngineVersion::Current().ToString()},
+			{TEXT("engineChangelist"), FString::FromInt(FEngineVersion::Current().GetChangelist())},
+			{TEXT("buildChangelist"), FString::FromInt(BuildSettings::GetCurrentChangelist())},
+			{TEXT("platform"), FPlatformProperties::IniPlatformName()},
+			{TEXT("os"), FPlatformMisc::GetOSVersion()},
+			{TEXT("cpu"), FPlatformMisc::GetCPUBrand().TrimStartAndEnd()},
+			{TEXT("cpuVendor"), FPlatformMisc::GetCPUVendor().TrimStartAndEnd()},
+			{TEXT("cpuCores"), FString::Printf(TEXT("%d (%d logical)"), FPlatformMisc::NumberOfCores(), FPlatformMisc::NumberOfCoresIncludingHyperthreads())},
+			{TEXT("gpu"), FPlatformMisc::GetPrimaryGPUBrand()},
+			{TEXT("ram"), FString::Printf(TEXT("%u GB"), MemoryConstants.TotalPhysicalGB)},
+		};
+		if (bIncludeCommandLine)
+		{
+			Gathered.Fields.Emplace(TEXT("commandLine"), FCommandLine::GetForLogging());
+		}
+		Gathered.EnabledPlugins = MoveTemp(EnabledPlugins);
+
+		return Gathered;
+	});
+}
+
+void FCodecksSystemMetadata::SetCustomField(const FString& Key, const FString& Value)
+{
+	FScopeLock Lock(&Mutex);
+
+	CustomFields.Add(Key, Value);
+	Serialized.Reset();
+}
+
+TSharedRef<const TArray64<uint8>, ESPMode::ThreadSafe> FCodecksSystemMetadata::GetSerialized() const
+{
+	if (GatherTask.IsValid())
+	{
+		GatherTask.Wait();
+	}
+
+	FScopeLock Lock(&Mutex);
+
+	if (Serialized.IsValid())
+	{
+		return Serialized.ToSharedRef();
+	}
+
+	FString Json;
+	const TSharedRef<TJsonWriter<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>> JsonWriter = TJsonWriterFactory<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>::Create(&Json);
+	JsonWriter->WriteObjectStart();
+
+	if (GatherTask.IsValid())
+	{
+		const FGatheredMetadata& Gathered = GatherTask.GetResult();
+		for (const TPair<FString, FString>& Field : Gathered.Fields)
+		{
+			JsonWriter->WriteValue(Field.Key, Field.Value);
+		}
+
+		JsonWriter->WriteValue(TEXT("enabledPlugins"), Gathered.EnabledPlugins);
+	}
+
+	JsonWriter->WriteObjectStart(TEXT("custom"));
+	for (const TPair<FString, FString>& Field : CustomFields)
+	{
+		JsonWriter->WriteValue(Field.Key, Field.Value);
+	}
+	JsonWriter->WriteObjectEnd();
+
+	JsonWriter->WriteObjectEnd();
+	JsonWriter->Close();
+
+	const FTCHARToUTF8 Utf8Json(*Json);
+	Serialized = MakeShared<const TArray64<uint8>, ESPMode::ThreadSafe>(reinterpret_cast<const uint8*>(Utf8Json.Get()), Utf8Json.Length());
+
+	return Serialized.ToSharedRef();
+}
@@ -0,0 +1,123 @@
+// Copyright(C) battyRabbit UG (limited liability). All Rights Reserved.
+
+#include "Memory/CodecksBufferPool.h"
+
+#include "CodecksUnreal.h"
+
+#include <Misc/ScopeLock.h>
+
+DECLARE_MEMORY_STAT(TEXT("Pooled Buffers"), STAT_CodecksPooledBufferBytes, STATGROUP_CodecksUnreal);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pooled Buffers Reused"), STAT_CodecksPooledBuffersReused, STATGROUP_CodecksUnreal);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pooled Buffers Allocated"), STAT_CodecksPooledBuffersAllocated, STATGROUP_CodecksUnreal);
+
+FCodecksBufferPool& FCodecksBufferPool::Get()
+{
+	static FCodecksBufferPool Pool;
+	return Pool;
+}
+
+TArray64<uint8> FCodecksBufferPool::Acquire(int64 MinCapacity)
+{
+	const int32 SizeClass = FMath::Max(static_cast<int32>(FMath::CeilLogTwo64(static_cast<uint64>(FMath::Max<int64>(MinCapacity, 1)))) - MinSizeClassLog2, 0);
+
+	{
+		FScopeLock Lock(&Mutex);
+		++Stats.Acquired;
+
+		// The next class up serves just as well, better than allocating
+		for (int32 CandidateClass = SizeClass; CandidateClass < FMath::Min(SizeClass + 2, NumSizeClasses); ++CandidateClass)
+		{
+			if (SizeClasses[CandidateClass].Num() > 0)
+			{
+				TArray64<uint8> Buffer = SizeClasses[CandidateClass].Pop(/*bAllowShrinking=*/false);
+
+				++Stats.Reused;
+				Stats.PooledBytes -= Buffer.Max();
+				INC_DWORD_STAT(STAT_CodecksPooledBuffersReused);
+				DEC_MEMORY_STAT_BY(STAT_CodecksPooledBufferBytes, Buffer.Max());
+
+				return Buffer;
+			}
+		}
+
+		++Stats.Allocated;
+		INC_DWORD_STAT(STAT_CodecksPooledBuffersAllocated);
+	}
+
+	// Round up to the class size, so the buffer is pooled under the class it was requested for
+	TArray64<uint8> Buffer;
+	Buffer.Reserve(SizeClass < NumSizeClasses ? int64(1) << (SizeClass + MinSizeClassLog2) : MinCapacity);
+	return Buffer;
+}
+
+void FCodecksBufferPool::Release(TArray64<uint8>&& Buffer)
+{
+	const int32 SizeClass = GetSizeClassForCapacity(Buffer.Max());
+
+	TArray64<uint8> Released = MoveTemp(Buffer);
+	Released.Reset();
+
+	FScopeLock Lock(&Mutex);
+
+	if (SizeClass == INDEX_NONE || SizeClasses[SizeClass].Num() >= MaxBuffersPerClass || Stats.PooledBytes + Released.Max() > MaxPooledBytes)
+	{
+		++Stats.Dropped;
+		return;
+	}
+
+	Stats.PooledBytes += Released.Max();
+	INC_MEMORY_STAT_BY(STAT_CodecksPooledBufferBytes, Released.Max());
+
+	SizeClasses[SizeClass].Add(MoveTemp(Released));
+}
+
+void FCodecksBufferPool::SetBudget(int64 InMaxPooledBytes)
+{
+	{
+		FScopeLock Lock(&Mutex);
+		MaxPooledBytes = FMath::Max<int64>(InMaxPooledBytes, 0);
+
+		if (Stats.PooledBytes <= MaxPooledBytes)
+		{
+			return;
+		}
+	}
+
+	Trim();
+}
+
+void FCodecksBufferPool::Trim()
+{
+	TArray<TArray64<uint8>> Trimmed[NumSizeClasses];
+	{
+		FScopeLock Lock(&Mutex);
+
+		for (int32 SizeClass = 0; SizeClass < NumSizeClasses; ++SizeClass)
+		{
+			Trimmed[SizeClass] = MoveTemp(SizeClasses[SizeClass]);
+		}
+
+		DEC_MEMORY_STAT_BY(STAT_CodecksPooledBufferBytes, Stats.PooledBytes);
+		Stats.PooledBytes = 0;
+	}
+
+	// Freed outside of the lock when Trimmed goes out of scope
+}
+
+FCodecksBufferPoolStats FCodecksBufferPool::GetStats() const
+{
+	FScopeLock Lock(&Mutex);
+	return Stats;
+}
+
+int32 FCodecksBufferPool::GetSizeClassForCapacity(int64 Capacity)
+{
+	if (Capacity < (int64(1) << MinSizeClassLog2))
+	{
+		// Not worth pooling
+		return INDEX_NONE;
+	}
+
+	// Pooled under the largest class the capacity covers, so every buffer of a class is at least that big
+	return FMath::Min(static_cast<int32>(FMath::FloorLog2_64(static_cast<uint64>(Capacity))) - MinSizeClassLog2, NumSizeClasses - 1);
+}
@@ -0,0 +1,206 @@
+// Copyright(C) battyRabbit UG (limited liability). All Rights Reserved.
+
+#include "Network/CodecksBandwidthLimiter.h"
+
+#include "CodecksUnreal.h"
+#include "Memory/CodecksBufferPool.h"
+
+#include <HAL/PlatformProcess.h>
+#include <HAL/PlatformTime.h>
+#include <Misc/ScopeLock.h>
+
+namespace CodecksBandwidthLimiter
+{
+	// Bucket saves up a quarter second of traffic at most, so idle time doesn't let several uploads through at once
+	constexpr double BucketSeconds = 0.25;
+
+	// Upper bound for a single sleep, so configuration changes are picked up quickly
+	constexpr float MaxSleepSeconds = 0.1f;
+
+	// Share of the configured limit regained per healthy sample in adaptive mode
+	constexpr double RecoveryFraction = 0.1;
+
+	// How fast the latency baseline follows the measured value upwards (it snaps down immediately)
+	constexpr float BaselineAdaption = 0.02f;
+}
+
+FCodecksBandwidthLimiter& FCodecksBandwidthLimiter::Get()
+{
+	static FCodecksBandwidthLimiter Limiter;
+	return Limiter;
+}
+
+void FCodecksBandwidthLimiter::Configure(int64 InBytesPerSecond, bool bInAdaptive)
+{
+	FScopeLock Lock(&Mutex);
+
+	BytesPerSecond = FMath::Max<int64>(InBytesPerSecond, 0);
+	EffectiveBytesPerSecond = BytesPerSecond;
+	bAdaptive = bInAdaptive;
+	BaselineLatency = -1.0f;
+
+	Tokens = 0.0;
+	LastRefillTime = FPlatformTime::Seconds();
+}
+
+void FCodecksBandwidthLimiter::ConfigureAdaptive(float InLatencyTolerance, float InPacketLossTolerance, int64 InMinBytesPerSecond)
+{
+	FScopeLock Lock(&Mutex);
+
+	LatencyTolerance = FMath::Max(InLatencyTolerance, 0.0f);
+	PacketLossTolerance = FMath::Clamp(InPacketLossTolerance, 0.0f, 1.0f);
+	MinBytesPerSecond = FMath::Max<int64>(InMinBytesPerSecond, 1);
+}
+
+int64 FCodecksBandwidthLimiter::GetEffectiveRate() const
+{
+	FScopeLock Lock(&Mutex);
+	return EffectiveBytesPerSecond;
+}
+
+void FCodecksBandwidthLimiter::Charge(int64 NumBytes)
+{
+	if (NumBytes <= 0)
+	{
+		return;
+	}
+
+	if (IsInGameThread())
+	{
+		if (IsThrottling())
+		{
+			UE_CALL_ONCE([] { UE_LOG(LogCodecksUnreal, Warning, TEXT("Upload bandwidth limit is ignored, uploads run on the game thread without task graph workers")); });
+		}
+		return;
+	}
+
+	while (true)
+	{
+		float WaitSeconds = 0.0f;
+		{
+			FScopeLock Lock(&Mutex);
+
+			// Throttling might have been disabled while we were waiting
+			if (EffectiveBytesPerSecond <= 0)
+			{
+				return;
+			}
+
+			Refill(FPlatformTime::Seconds());
+
+			if (Tokens >= 0.0)
+			{
+				Tokens -= NumBytes;
+				return;
+			}
+
+			WaitSeconds = static_cast<float>(-Tokens / EffectiveBytesPerSecond);
+		}
+
+		FPlatformProcess::Sleep(FMath::Min(WaitSeconds, CodecksBandwidthLimiter::MaxSleepSeconds));
+	}
+}
+
+void FCodecksBandwidthLimiter::ReportNetworkConditions(float LatencySeconds, float PacketLoss)
+{
+	FScopeLock Lock(&Mutex);
+
+	if (!bAdaptive || BytesPerSecond <= 0)
+	{
+		return;
+	}
+
+	if (BaselineLatency < 0.0f || LatencySeconds < BaselineLatency)
+	{
+		BaselineLatency = LatencySeconds;
+	}
+	else
+	{
+		BaselineLatency = FMath::Lerp(BaselineLatency, LatencySeconds, CodecksBandwidthLimiter::BaselineAdaption);
+	}
+
+	const bool bCongested = LatencySeconds > BaselineLatency + LatencyTolerance || PacketLoss > PacketLossTolerance;
+
+	Refill(FPlatformTime::Seconds());
+
+	if (bCongested)
+	{
+		EffectiveBytesPerSecond = FMath::Max(EffectiveBytesPerSecond / 2, FMath::Min(MinBytesPerSecond, BytesPerSecond));
+	}
+	else
+	{
+		const int64 Recovery = FMath::Max<int64>(static_cast<int64>(BytesPerSecond * CodecksBandwidthLimiter::RecoveryFraction), 1);
+		EffectiveBytesPerSecond = FMath::Min(EffectiveBytesPerSecond + Recovery, BytesPerSecond);
+	}
+
+	Tokens = FMath::Min(Tokens, GetCapacity());
+}
+
+void FCodecksBandwidthLimiter::Refill(double Now)
+{
+	const double Elapsed = FMath::Max(Now - LastRefillTime, 0.0);
+	LastRefillTime = Now;
+
+	Tokens = FMath::Min(Tokens + Elapsed * EffectiveBytesPerSecond, GetCapacity());
+}
+
+double FCodecksBandwidthLimiter::GetCapacity() const
+{
+	return FMath::Max(EffectiveBytesPerSecond * CodecksBandwidthLimiter::BucketSeconds, 1.0);
+}
+
+FCodecksUploadArchive::FCodecksUploadArchive(TArray64<uint8>&& InBytes)
+	: Head(MoveTemp(InBytes))
+{
+	SetIsLoading(true);
+	SetIsPersistent(false);
+}
+
+FCodecksUploadArchive::FCodecksUploadArchive(TArray64<uint8>&& InHead, FCodecksUploadSection InShared, TArray64<uint8>&& InTail)
+	: Head(MoveTemp(InHead))
+	, Shared(InShared)
+	, Tail(MoveTemp(InTail))
+{
+	SetIsLoading(true);
+	SetIsPersistent(false);
+}
+
+FCodecksUploadArchive::~FCodecksUploadArchive()
+{
+	FCodecksBufferPool::Get().Release(MoveTemp(Head));
+}
+
+void FCodecksUploadArchive::Serialize(void* Data, int64 Num)
+{
+	const int64 Available = FMath::Clamp<int64>(TotalSize() - Offset, 0, Num);
+	if (Available < Num)
+	{
+		SetError();
+	}
+
+	const TArrayView64<const uint8> Parts[] = {
+		Head,
+		Shared ? TArrayView64<const uint8>(*Shared) : TArrayView64<const uint8>(),
+		Tail
+	};
+
+	uint8* Dest = static_cast<uint8*>(Data);
+	int64 Remaining = Available;
+	int64 PartStart = 0;
+	for (const TArrayView64<const uint8>& Part : Parts)
+	{
+		// Offset may fall into any part, a read may span several of them
+		const int64 PartOffset = Offset - PartStart;
+		if (Remaining > 0 && PartOffset < Part.Num())
+		{
+			const int64 Copied = FMath::Min(Part.Num() - PartOffset, Remaining);
+			FMemory::Memcpy(Dest, Part.GetData() + PartOffset, Copied);
+
+			Dest += Copied;
+			Offset += Copied;
+			Remaining -= Copied;
+		}
+
+		PartStart += Part.Num();
+	}
+}
@@ -0,0 +1,105 @@
+// Copyright(C) battyRabbit UG (limited liability). All Rights Reserved.
+
+#include "Network/CodecksConnectionPrewarmer.h"
+
+#include "CodecksUnreal.h"
+#include "Settings/CodecksSettings.h"
+
+#include <HttpModule.h>
+#include <Interfaces/IHttpRequest.h>
+#include <Interfaces/IHttpResponse.h>
+#include <Misc/ScopeLock.h>
+
+namespace CodecksConnectionPrewarmer
+{
+	// Idle connections don't survive much longer than this in the connection cache, so warming again before is wasted
+	constexpr double RewarmSeconds = 30.0;
+
+	constexpr float TimeoutSeconds = 10.0f;
+}
+
+FCodecksConnectionPrewarmer& FCodecksConnectionPrewarmer::Get()
+{
+	static FCodecksConnectionPrewarmer Prewarmer;
+	return Prewarmer;
+}
+
+void FCodecksConnectionPrewarmer::Prewarm()
+{
+	const UCodecksSettings* CodecksSettings = GetDefault<UCodecksSettings>();
+
+	TArray<FString> Urls = {CodecksSettings->GetApiUrl(), CodecksSettings->GetPrewarmUploadUrl()};
+	{
+		FScopeLock Lock(&Mutex);
+		Urls.Append(UploadOrigins.Array());
+	}
+
+	for (const FString& Url : Urls)
+	{
+		PrewarmUrl(Url);
+	}
+}
+
+void FCodecksConnectionPrewarmer::PrewarmUrl(const FString& Url, FSimpleDelegate OnWarmed)
+{
+	const FString Origin = GetOrigin(Url);
+	if (Origin.IsEmpty())
+	{
+		OnWarmed.ExecuteIfBound();
+		return;
+	}
+
+	{
+		FScopeLock Lock(&Mutex);
+
+		const double Now = FPlatformTime::Seconds();
+		const double* LastWarmedTime = LastWarmed.Find(Origin);
+		if (LastWarmedTime && Now - *LastWarmedTime < CodecksConnectionPrewarmer::RewarmSeconds)
+		{
+			OnWarmed.ExecuteIfBound();
+			return;
+		}
+
+		LastWarmed.Add(Origin, Now);
+	}
+
+	// The response doesn't matter (the api root might as well 404), only the connection it leaves behind
+	const TSharedRef<IHttpRequest> WarmRequest = FHttpModule::Get().CreateRequest();
+	WarmRequest->SetVerb("HEAD");
+	WarmRequest->SetURL(Origin);
+	WarmRequest->SetTimeout(CodecksConnectionPrewarmer::TimeoutSeconds);
+	WarmRequest->OnProcessRequestComplete().BindLambda([Origin, OnWarmed](FHttpRequestPtr /*Request*/, FHttpResponsePtr /*Response*/, bool bConnectedSuccessfully) {
+		UE_LOG(LogCodecksUnreal, Verbose, TEXT("Pre-warming %s %s"), *Origin, bConnectedSuccessfully ? TEXT("succeeded") : TEXT("failed"));
+		OnWarmed.ExecuteIfBound();
+	});
+
+	if (!WarmRequest->ProcessRequest())
+	{
+		OnWarmed.ExecuteIfBound();
+	}
+}
+
+void FCodecksConnectionPrewarmer::NoteUploadUrl(const FString& Url)
+{
+	const FString Origin = GetOrigin(Url);
+	if (!Origin.IsEmpty())
+	{
+		FScopeLock Lock(&Mutex);
+		UploadOrigins.Add(Origin);
+	}
+}
+
+FString FCodecksConnectionPrewarmer::GetOrigin(const FString& Url)
+{
+	const int32 SchemeEnd = Url.Find(TEXT("://"));
+	if (SchemeEnd == INDEX_NONE)
+	{
+		return FString();
+	}
+
+	const int32 HostStart = SchemeEnd + 3;
+	const int32 PathStart = Url.Find(TEXT("/"), ESearchCase::CaseSensitive, ESearchDir::FromStart, HostStart);
+	const FString Origin = PathStart == INDEX_NONE ? Url : Url.Left(PathStart);
+
+	return Origin.Len() > HostStart ? Origin + TEXT("/") : FString();
+}
@@ -0,0 +1,220 @@
+// Copyright(C) battyRabbit UG (limited liability). All Rights Reserved.
+
+#include "Requests/CodecksAttachmentCache.h"
+
+#include "CodecksUnreal.h"
+#include "Memory/CodecksBufferPool.h"
+#include "Requests/CodecksAttachments.h"
+
+#include <Hash/xxhash.h>
+#include <Misc/ScopeLock.h>
+#include <Serialization/MemoryWriter.h>
+
+DECLARE_MEMORY_STAT(TEXT("Attachment Cache"), STAT_CodecksAttachmentCacheBytes, STATGROUP_CodecksUnreal);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Attachment Cache Hits"), STAT_CodecksAttachmentCacheHits, STATGROUP_CodecksUnreal);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Attachment Cache Misses"), STAT_CodecksAttachmentCacheMisses, STATGROUP_CodecksUnreal);
+
+FCodecksSharedAttachment::FCodecksSharedAttachment(const FCodecksAttachedFile& File)
+	: Filename(File.Filename)
+	, ContentType(File.ContentType)
+	, Section(MakeShared<const TArray64<uint8>, ESPMode::ThreadSafe>(FCodecksAttachmentCache::EncodeSection(File)))
+{}
+
+FCodecksAttachmentCache& FCodecksAttachmentCache::Get()
+{
+	static FCodecksAttachmentCache Cache;
+	return Cache;
+}
+
+FCodecksUploadSection FCodecksAttachmentCache::FindOrEncode(const FCodecksAttachedFile& File)
+{
+	bool bCacheable = false;
+	{
+		FScopeLock Lock(&Mutex);
+
+		// Caching disabled or the file alone exceeds the budget, not worth hashing then
+		bCacheable = MaxCachedBytes > 0 && File.Binary.Num() <= MaxCachedBytes;
+		if (!bCacheable)
+		{
+			++Stats.Misses;
+			INC_DWORD_STAT(STAT_CodecksAttachmentCacheMisses);
+		}
+	}
+
+	if (!bCacheable)
+	{
+		return EncodePooled(File);
+	}
+
+	FKey Key;
+	Key.ContentHash = FXxHash64::HashBuffer(File.Binary.GetData(), File.Binary.Num()).Hash;
+	Key.Size = File.Binary.Num();
+	Key.Filename = File.Filename;
+	Key.ContentType = File.ContentType;
+
+	{
+		FScopeLock Lock(&Mutex);
+
+		const int32 Index = Entries.IndexOfByPredicate([&Key](const FEntry& Entry) { return Entry.Key == Key; });
+		if (Index != INDEX_NONE)
+		{
+			++Stats.Hits;
+			INC_DWORD_STAT(STAT_CodecksAttachmentCacheHits);
+
+			// Most recently used goes last
+			FEntry Entry = MoveTemp(Entries[Index]);
+			Entries.RemoveAt(Index, 1, /*bAllowShrinking=*/false);
+			return Entries.Add_GetRef(MoveTemp(Entry)).Section;
+		}
+
+		++Stats.Misses;
+		INC_DWORD_STAT(STAT_CodecksAttachmentCacheMisses);
+
+		// The first sighting only remembers the key, one-off attachments never take up the budget
+		bCacheable = CheckSeen(Key);
+	}
+
+	if (!bCacheable)
+	{
+		return EncodePooled(File);
+	}
+
+	// Encoded outside the lock, two uploads missing on the same file at once both encode it and the first one is kept
+	FCodecksUploadSection Section = MakeShared<const TArray64<uint8>, ESPMode::ThreadSafe>(EncodeSection(File));
+
+	TArray<FEntry> Evicted;
+	{
+		FScopeLock Lock(&Mutex);
+
+		if (const FEntry* Existing = Entries.FindByPredicate([&Key](const FEntry& Entry) { return Entry.Key == Key; }))
+		{
+			return Existing->Section;
+		}
+
+		++Stats.Admitted;
+		Stats.CachedBytes += Section->Num();
+		INC_MEMORY_STAT_BY(STAT_CodecksAttachmentCacheBytes, Section->Num());
+		Entries.Add(FEntry{MoveTemp(Key), Section});
+
+		EvictToBudget(Evicted);
+	}
+
+	// Evicted sections are freed outside of the lock when Evicted goes out of scope, unless still uploading
+	return Section;
+}
+
+TArray64<uint8> FCodecksAttachmentCache::EncodeSection(const FCodecksAttachedFile& File)
+{
+	TArray64<uint8> Bytes;
+	Bytes.Reserve(GetSectionSize(File));
+	EncodeSectionInto(File, Bytes);
+	return Bytes;
+}
+
+FCodecksUploadSection FCodecksAttachmentCache::EncodePooled(const FCodecksAttachedFile& File)
+{
+	TArray64<uint8>* Bytes = new TArray64<uint8>(FCodecksBufferPool::Get().Acquire(GetSectionSize(File)));
+	EncodeSectionInto(File, *Bytes);
+
+	// Goes back to the pool once the last upload streaming it is done
+	return FCodecksUploadSection(MakeShareable(Bytes, [](TArray64<uint8>* Section) {
+		FCodecksBufferPool::Get().Release(MoveTemp(*Section));
+		delete Section;
+	}));
+}
+
+int64 FCodecksAttachmentCache::GetSectionSize(const FCodecksAttachedFile& File)
+{
+	// Fixed header text, filename, content type and payload
+	return 96 + File.Filename.Len() + File.ContentType.Len() + File.Binary.Num();
+}
+
+void FCodecksAttachmentCache::EncodeSectionInto(const FCodecksAttachedFile& File, TArray64<uint8>& Bytes)
+{
+	const FString CLRF("\r\n");
+
+	// Format the file the way S3 wants it (in a form, with the file contents being a field called "file")
+	const FString FileHeader("Content-Disposition: form-data; name=\"file\"; filename=\"" + File.Filename + "\"");
+	const FString ContentType("Content-Type: " + File.ContentType);
+
+	FMemoryWriter64 Writer(Bytes);
+	Writer.Serialize(const_cast<ANSICHAR*>(StringCast<ANSICHAR>(*FileHeader).Get()), FileHeader.Len());
+	Writer.Serialize(const_cast<ANSICHAR*>(StringCast<ANSICHAR>(*CLRF).Get()), CLRF.Len());
+
+	Writer.Serialize(const_cast<ANSICHAR*>(StringCast<ANSICHAR>(*ContentType).Get()), ContentType.Len());
+	Writer.Serialize(const_cast<ANSICHAR*>(StringCast<ANSICHAR>(*CLRF).Get()), CLRF.Len());
+
+	// Empty line between form-data header and content **IS** important
+	Writer.Serialize(const_cast<ANSICHAR*>(StringCast<ANSICHAR>(*CLRF).Get()), CLRF.Len());
+
+	Writer.Serialize(const_cast<uint8*>(File.Binary.GetData()), File.Binary.Num());
+	Writer.Close();
+}
+
+void FCodecksAttachmentCache::SetBudget(int64 InMaxCachedBytes)
+{
+	TArray<FEntry> Evicted;
+
+	FScopeLock Lock(&Mutex);
+	MaxCachedBytes = FMath::Max<int64>(InMaxCachedBytes, 0);
+	EvictToBudget(Evicted);
+}
+
+void FCodecksAttachmentCache::Trim()
+{
+	TArray<FEntry> Trimmed;
+	{
+		FScopeLock Lock(&Mutex);
+
+		Trimmed = MoveTemp(Entries);
+		SeenKeys.Empty();
+
+		DEC_MEMORY_STAT_BY(STAT_CodecksAttachmentCacheBytes, Stats.CachedBytes);
+		Stats.CachedBytes = 0;
+	}
+
+	// Freed outside of the lock when Trimmed goes out of scope
+}
+
+FCodecksAttachmentCacheStats FCodecksAttachmentCache::GetStats() const
+{
+	FScopeLock Lock(&Mutex);
+
+	FCodecksAttachmentCacheStats Result = Stats;
+	Result.Entries = Entries.Num();
+	return Result;
+}
+
+bool FCodecksAttachmentCache::CheckSeen(const FKey& Key)
+{
+	const int32 Index = SeenKeys.IndexOfByKey(Key);
+	if (Index != INDEX_NONE)
+	{
+		SeenKeys.RemoveAt(Index, 1, /*bAllowShrinking=*/false);
+		return true;
+	}
+
+	if (SeenKeys.Num() >= MaxSeenKeys)
+	{
+		SeenKeys.RemoveAt(0, 1, /*bAllowShrinking=*/false);
+	}
+	SeenKeys.Add(Key);
+	return false;
+}
+
+void FCodecksAttachmentCache::EvictToBudget(TArray<FEntry>& OutEvicted)
+{
+	int32 NumEvicted = 0;
+	while (NumEvicted < Entries.Num() && Stats.CachedBytes > MaxCachedBytes)
+	{
+		const int64 SectionSize = Entries[NumEvicted].Section->Num();
+		Stats.CachedBytes -= SectionSize;
+		++Stats.Evicted;
+		DEC_MEMORY_STAT_BY(STAT_CodecksAttachmentCacheBytes, SectionSize);
+
+		OutEvicted.Add(MoveTemp(Entries[NumEvicted]));
+		++NumEvicted;
+	}
+
+	Entries.RemoveAt(0, NumEvicted, /*bAllowShrinking=*/false);
+}
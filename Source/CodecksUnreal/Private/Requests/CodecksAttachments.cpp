@@ -0,0 +1,149 @@
+// Copyright(C) battyRabbit UG (limited liability). All Rights Reserved.
+
+#include "Requests/CodecksAttachments.h"
+
+#include <Algo/BinarySearch.h>
+#include <Misc/ScopeRWLock.h>
+
+#include <atomic>
+
+namespace CodecksAttachments
+{
+	// Shared by all lists, so a handle can't accidentally resolve on a different report
+	std::atomic<uint32> NextId{1};
+}
+
+FCodecksAttachmentHandle FCodecksAttachmentList::Add(FString Filename)
+{
+	return Add(FCodecksAttachedFile{MoveTemp(Filename)});
+}
+
+FCodecksAttachmentHandle FCodecksAttachmentList::Add(FCodecksAttachedFile&& File)
+{
+	FCodecksAttachedFileRef NewFile = MakeShared<const FCodecksAttachedFile, ESPMode::ThreadSafe>(MoveTemp(File));
+
+	FWriteScopeLock WriteLock(Lock);
+
+	// Drawn while holding the lock, so slots stay sorted by id
+	const uint32 Id = CodecksAttachments::NextId.fetch_add(1, std::memory_order_relaxed);
+	Slots.Add(FSlot{Id, MoveTemp(NewFile)});
+
+	return FCodecksAttachmentHandle(Id);
+}
+
+FCodecksAttachmentHandle FCodecksAttachmentList::AddLazy(FString Filename, FCodecksAttachmentProvider Provider)
+{
+	check(Provider);
+
+	FCodecksAttachedFile File;
+	File.Filename = MoveTemp(Filename);
+	File.Provider = MoveTemp(Provider);
+
+	return Add(MoveTemp(File));
+}
+
+bool FCodecksAttachmentList::SetPayload(const FCodecksAttachmentHandle& Handle, TArray64<uint8>&& Binary, FString ContentType)
+{
+	if (!Handle.IsValid())
+	{
+		return false;
+	}
+
+	FString Filename;
+	{
+		FReadScopeLock ReadLock(Lock);
+
+		const int32 SlotIndex = FindSlotIndex(Handle.Id);
+		if (SlotIndex == INDEX_NONE)
+		{
+			return false;
+		}
+
+		Filename = Slots[SlotIndex].File->Filename;
+	}
+
+	// Build the new file outside of the lock, only the swap needs exclusive access
+	FCodecksAttachedFileRef NewFile = MakeShared<const FCodecksAttachedFile, ESPMode::ThreadSafe>(FCodecksAttachedFile{MoveTemp(Filename), MoveTemp(Binary), MoveTemp(ContentType)});
+
+	FWriteScopeLock WriteLock(Lock);
+
+	const int32 SlotIndex = FindSlotIndex(Handle.Id);
+	if (SlotIndex == INDEX_NONE)
+	{
+		return false;
+	}
+
+	Slots[SlotIndex].File = MoveTemp(NewFile);
+	return true;
+}
+
+TSharedPtr<const FCodecksAttachedFile, ESPMode::ThreadSafe> FCodecksAttachmentList::Find(const FCodecksAttachmentHandle& Handle) const
+{
+	FReadScopeLock ReadLock(Lock);
+
+	const int32 SlotIndex = FindSlotIndex(Handle.Id);
+	if (SlotIndex == INDEX_NONE)
+	{
+		return nullptr;
+	}
+
+	return Slots[SlotIndex].File;
+}
+
+TSharedPtr<const FCodecksAttachedFile, ESPMode::ThreadSafe> FCodecksAttachmentList::FindByFilename(const FString& Filename) const
+{
+	FReadScopeLock ReadLock(Lock);
+
+	const FSlot* Slot = Slots.FindByPredicate([&Filename](const FSlot& A) { return A.File->Filename.Compare(Filename) == 0; });
+	if (!Slot)
+	{
+		return nullptr;
+	}
+
+	return Slot->File;
+}
+
+TArray<FCodecksAttachedFileRef> FCodecksAttachmentList::GetSnapshot() const
+{
+	TArray<FCodecksAttachedFileRef> Snapshot;
+
+	FReadScopeLock ReadLock(Lock);
+
+	Snapshot.Reserve(Slots.Num());
+	for (const FSlot& Slot : Slots)
+	{
+		Snapshot.Add(Slot.File);
+	}
+
+	return Snapshot;
+}
+
+int32 FCodecksAttachmentList::Num() const
+{
+	FReadScopeLock ReadLock(Lock);
+	return Slots.Num();
+}
+
+TSharedPtr<const FCodecksAttachedFile, ESPMode::ThreadSafe> FCodecksAttachmentList::Provide(const FCodecksAttachedFileRef& File)
+{
+	if (!File->IsLazy())
+	{
+		return File;
+	}
+
+	FCodecksAttachedFile ProvidedFile;
+	ProvidedFile.Filename = File->Filename;
+	ProvidedFile.ContentType = "application/octet-stream";
+
+	if (!File->Provider(ProvidedFile.Binary, ProvidedFile.ContentType))
+	{
+		return nullptr;
+	}
+
+	return MakeShared<const FCodecksAttachedFile, ESPMode::ThreadSafe>(MoveTemp(ProvidedFile));
+}
+
+int32 FCodecksAttachmentList::FindSlotIndex(uint32 Id) const
+{
+	return Algo::BinarySearchBy(Slots, Id, &FSlot::Id);
+}
@@ -2,7 +2,14 @@
 
 #include "Requests/CodecksUserReportRequest.h"
 
+#include "CodecksReplayRingBuffer.h"
 #include "CodecksUnreal.h"
+#include "Diagnostics/CodecksReplayRecorder.h"
+#include "Diagnostics/CodecksSystemMetadata.h"
+#include "Memory/CodecksBufferPool.h"
+#include "Network/CodecksBandwidthLimiter.h"
+#include "Network/CodecksConnectionPrewarmer.h"
+#include "Requests/CodecksAttachmentCache.h"
 #include "Settings/CodecksSettings.h"
 
 #include <HttpModule.h>
@@ -10,6 +17,7 @@
 #include <ImageWrapperHelper.h>
 
 #include <Interfaces/IHttpResponse.h>
+#include <Serialization/MemoryWriter.h>
 
 #include <Tasks/Task.h>
 #include <Tasks/Pipe.h>
@@ -21,7 +29,12 @@ void UCodecksUserReportRequest::BeginDestroy()
 {
 	UObject::BeginDestroy();
 	FScreenshotRequest::OnScreenshotCaptured().RemoveAll(this);
-	GEngine->GameViewport->OnScreenshotCaptured().RemoveAll(this);
+
+	// No viewport on dedicated servers
+	if (GEngine && GEngine->GameViewport)
+	{
+		GEngine->GameViewport->OnScreenshotCaptured().RemoveAll(this);
+	}
 }
 
 void UCodecksUserReportRequest::BuildRequest()
@@ -67,26 +80,19 @@ FString UCodecksUserReportRequest::GetReportToken() const
 	return CodecksSettings->GetReportToken();
 }
 
-void UCodecksUserReportRequest::AttachIntermediateScreenshot(bool bShowUI)
+FCodecksAttachmentHandle UCodecksUserReportRequest::AttachIntermediateScreenshot(bool bShowUI)
 {
 	const FString DateName = FDateTime::Now().ToString(TEXT("%Y-%m-%d %H-%M-%S"));
 	const FString Filename = DateName + ".png";
 
-	int32 NewScreenshot = AttachedFiles.Add(FAttachedFile{Filename});
+	const FCodecksAttachmentHandle NewScreenshot = Attachments.Add(Filename);
 
 	ScreenshotPipe.Launch(TEXT("Codecks_FetchScreenshot"), [this, NewScreenshot, bShowUI]() {
 		UE::Tasks::FTaskEvent WaitForScreenshot(UE_SOURCE_LOCATION);
 
 		const FDelegateHandle Delegate = GEngine->GameViewport->OnScreenshotCaptured().AddWeakLambda(this, [this, NewScreenshot, &WaitForScreenshot](int32 Width, int32 Height, const TArray<FColor>& Colors) {
-			Async(EAsyncExecution::TaskGraph, [this, Width, Height, NewScreenshot, Colors, &WaitForScreenshot]() {
-				TArray64<uint8> CompressedBitmap;
-				FImageUtils::PNGCompressImageArray(Width, Height, TArrayView64<const FColor>(Colors.GetData(), Colors.Num()), CompressedBitmap);
-
-				if (AttachedFiles.IsValidIndex(NewScreenshot))
-				{
-					AttachedFiles[NewScreenshot].Binary = MoveTemp(CompressedBitmap);
-					AttachedFiles[NewScreenshot].ContentType = "image/png";
-				}
+			Async(EAsyncExecution::TaskGraph, [this, Width, Height, NewScreenshot, Pixels = CopyScreenshotPixels(Colors), &WaitForScreenshot]() mutable {
+				Attachments.SetPayload(NewScreenshot, CompressScreenshot(Width, Height, MoveTemp(Pixels)), "image/png");
 
 				AsyncTask(ENamedThreads::GameThread, [&WaitForScreenshot]() { WaitForScreenshot.Trigger(); });
 			});
@@ -98,6 +104,24 @@ void UCodecksUserReportRequest::AttachIntermediateScreenshot(bool bShowUI)
 
 		GEngine->GameViewport->OnScreenshotCaptured().Remove(Delegate);
 	});
+
+	return NewScreenshot;
+}
+
+TArray64<uint8> UCodecksUserReportRequest::CopyScreenshotPixels(const TArray<FColor>& Colors)
+{
+	// Pixels go into a pooled buffer instead of a fresh copy of the array for every report
+	TArray64<uint8> Pixels = FCodecksBufferPool::Get().Acquire(Colors.Num() * sizeof(FColor));
+	Pixels.Append(reinterpret_cast<const uint8*>(Colors.GetData()), Colors.Num() * sizeof(FColor));
+	return Pixels;
+}
+
+TArray64<uint8> UCodecksUserReportRequest::CompressScreenshot(int32 Width, int32 Height, TArray64<uint8>&& Pixels)
+{
+	TArray64<uint8> CompressedBitmap;
+	FImageUtils::PNGCompressImageArray(Width, Height, TArrayView64<const FColor>(reinterpret_cast<const FColor*>(Pixels.GetData()), Pixels.Num() / sizeof(FColor)), CompressedBitmap);
+	FCodecksBufferPool::Get().Release(MoveTemp(Pixels));
+	return CompressedBitmap;
 }
 
 void UCodecksUserReportRequest::AddRequestData(const TSharedPtr<FJsonObject>& JsonObject)
@@ -135,35 +159,69 @@ void UCodecksUserReportRequest::AddRequestData(const TSharedPtr<FJsonObject>& Js
 
 	JsonObject->SetStringField("userEmail", UserEmail);
 
+	// Gathered at startup, so this only hands out the pre-serialized block once the upload asks for it
+	if (bAttachSystemMetadata && GetDefault<UCodecksSettings>()->ShouldAttachSystemMetadata() && !Attachments.FindByFilename(FCodecksSystemMetadata::GetFilename()))
+	{
+		AttachLazy(FCodecksSystemMetadata::GetFilename(), [](TArray64<uint8>& OutBinary, FString& OutContentType) {
+			OutBinary = *FCodecksSystemMetadata::Get().GetSerialized();
+			OutContentType = "application/json";
+			return true;
+		});
+	}
+
+	// The window ends now, saving and compressing it is left to the upload workers
+	if (bAttachReplay && GetDefault<UCodecksSettings>()->ShouldRecordReplayForReports() && !Attachments.FindByFilename(FCodecksReplayRecorder::GetFilename()))
+	{
+		TSharedRef<const FCodecksReplaySnapshot, ESPMode::ThreadSafe> Replay = MakeShared<const FCodecksReplaySnapshot, ESPMode::ThreadSafe>(FCodecksReplayRingBuffer::Get().Snapshot());
+		if (!Replay->IsEmpty())
+		{
+			AttachLazy(FCodecksReplayRecorder::GetFilename(), [Replay](TArray64<uint8>& OutBinary, FString& OutContentType) {
+				OutContentType = "application/octet-stream";
+				return Replay->Save(OutBinary);
+			});
+		}
+	}
+
 	TArray<TSharedPtr<FJsonValue>> JsonFilenames;
-	auto AddFilenamesForAttachments = [&JsonFilenames](const TArrayView<FAttachedFile>& Files) {
-		for (const FAttachedFile& File : Files)
+	auto AddFilenamesForAttachments = [&JsonFilenames](const TArrayView<const FCodecksAttachedFileRef>& Files) {
+		for (const FCodecksAttachedFileRef& File : Files)
 		{
-			JsonFilenames.Add(MakeShared<FJsonValueString>(File.Filename));
+			JsonFilenames.Add(MakeShared<FJsonValueString>(File->Filename));
 		}
 	};
 
-	AddFilenamesForAttachments(AttachedFiles);
+	AddFilenamesForAttachments(Attachments.GetSnapshot());
 
 	JsonObject->SetArrayField("fileNames", JsonFilenames);
 }
 
-void UCodecksUserReportRequest::AttachFile(const FString& Filename, const FString& FileContents)
+FCodecksAttachmentHandle UCodecksUserReportRequest::AttachFile(const FString& Filename, const FString& FileContents)
+{
+	return AttachFile(Filename, TArray64<uint8>(reinterpret_cast<const uint8*>(GetData(FileContents)), FileContents.GetAllocatedSize()), "text/plain");
+}
+
+FCodecksAttachmentHandle UCodecksUserReportRequest::AttachFile(const FString& Filename, const TArrayView64<uint8>& Binary, FString ContentType)
+{
+	return AttachFile(Filename, TArray64<uint8>(Binary), MoveTemp(ContentType));
+}
+
+FCodecksAttachmentHandle UCodecksUserReportRequest::AttachFile(const FString& Filename, TArray64<uint8>&& Binary, FString ContentType)
 {
-	AttachFile(Filename, TArray64<uint8>(reinterpret_cast<const uint8*>(GetData(FileContents)), FileContents.GetAllocatedSize()), "text/plain");
+	return Attachments.Add(FCodecksAttachedFile{Filename, MoveTemp(Binary), MoveTemp(ContentType)});
 }
 
-void UCodecksUserReportRequest::AttachFile(const FString& Filename, const TArrayView64<uint8>& Binary, FString ContentType)
+FCodecksAttachmentHandle UCodecksUserReportRequest::AttachLazy(const FString& Filename, FCodecksAttachmentProvider Provider)
 {
-	FAttachedFile& AttachedFile = AttachedFiles.AddDefaulted_GetRef();
-	AttachedFile.Filename = Filename;
-	AttachedFile.Binary = Binary;
-	AttachedFile.ContentType = ContentType;
+	return Attachments.AddLazy(Filename, MoveTemp(Provider));
 }
 
-void UCodecksUserReportRequest::AttachFile(const FString& Filename, TArray64<uint8>&& Binary, FString ContentType)
+FCodecksAttachmentHandle UCodecksUserReportRequest::AttachShared(const FCodecksSharedAttachment& Shared)
 {
-	AttachFile(Filename, TArrayView64<uint8>(MoveTemp(Binary)), ContentType);
+	FCodecksAttachedFile File;
+	File.Filename = Shared.Filename;
+	File.ContentType = Shared.ContentType;
+	File.SharedSection = Shared.Section;
+	return Attachments.Add(MoveTemp(File));
 }
 
 bool UCodecksUserReportRequest::IsOk() const
@@ -176,6 +234,11 @@ FName UCodecksUserReportRequest::Error() const
 	return RequestState_Error;
 }
 
+void UCodecksUserReportRequest::PrewarmConnections()
+{
+	FCodecksConnectionPrewarmer::Get().Prewarm();
+}
+
 void UCodecksUserReportRequest::CreateReport()
 {
 	CreateReport({});
@@ -200,7 +263,23 @@ void UCodecksUserReportRequest::CreateReport(const TFunction<void(UCodecksUserRe
 	Succeed(ECodecksRequestState::Initialized);
 	UpdateCall(this);
 
-	HttpRequest->OnProcessRequestComplete().BindWeakLambda(this, [this, UpdateCall](FHttpRequestPtr /*Request*/, FHttpResponsePtr Response, bool /*bConnectedSuccessfully*/) {
+	HttpRequest->OnProcessRequestComplete().BindWeakLambda(this, [this, UpdateCall](FHttpRequestPtr /*Request*/, FHttpResponsePtr Response, bool bConnectedSuccessfully) {
+		// No response means no upload urls either, so there is nothing left to do
+		if (!bConnectedSuccessfully || !Response.IsValid())
+		{
+			Fail(CodecksRequestErrors::NoConnection);
+			UpdateCall(this);
+			return;
+		}
+
+		if (!EHttpResponseCodes::IsOk(Response->GetResponseCode()))
+		{
+			UE_LOG(LogCodecksUnreal, Warning, TEXT("Creating report failed with %d: %s"), Response->GetResponseCode(), *Response->GetContentAsString());
+			Fail(CodecksRequestErrors::ErrorResponse);
+			UpdateCall(this);
+			return;
+		}
+
 		TSharedPtr<FJsonObject> JsonObject = MakeShared<FJsonObject>();
 
 		Succeed(ECodecksRequestState::ReportSubmitted);
@@ -239,6 +318,7 @@ void UCodecksUserReportRequest::CreateReport(const TFunction<void(UCodecksUserRe
 	if (!HttpRequest->ProcessRequest())
 	{
 		Fail(CodecksRequestErrors::UnableToProcess);
+		UpdateCall(this);
 	}
 }
 
@@ -263,6 +343,52 @@ void UCodecksUserReportRequest::ResetState()
 	RequestState_Error = FName();
 }
 
+TSharedRef<FCodecksUploadArchive, ESPMode::ThreadSafe> UCodecksUserReportRequest::MakeUploadBody(const FCodecksAttachedFile& File, const FJsonObject& FormFields, const FString& FormBoundary)
+{
+	// Proceed building multipart/form-data
+	FString CLRF("\r\n");
+	FString Dash("--");
+
+	// Room for the form fields, so the writer doesn't have to grow the pooled buffer. The file itself is shared.
+	TArray64<uint8> Bytes = FCodecksBufferPool::Get().Acquire(16 * 1024);
+	FMemoryWriter64 Writer(Bytes, false, false);
+	Writer.Seek(0);
+
+	FString FormStartBoundary = CLRF + Dash + FormBoundary + CLRF;
+
+	// Set all meta fields according to AWS
+	for (const TTuple<FString, TSharedPtr<FJsonValue>>& Field : FormFields.Values)
+	{
+		Writer.Serialize(const_cast<ANSICHAR*>(StringCast<ANSICHAR>(*FormStartBoundary).Get()), FormStartBoundary.Len());
+
+		FString header("Content-Disposition: form-data; name=\"" + Field.Key + "\"");
+		Writer.Serialize(const_cast<ANSICHAR*>(StringCast<ANSICHAR>(*header).Get()), header.Len());
+		Writer.Serialize(const_cast<ANSICHAR*>(StringCast<ANSICHAR>(*CLRF).Get()), CLRF.Len());
+
+		// Also add content-type here, because you have to for S3
+		FString ContentType = "Content-Type: text/plain; encoding=utf8";
+		Writer.Serialize(const_cast<ANSICHAR*>(StringCast<ANSICHAR>(*ContentType).Get()), ContentType.Len());
+		Writer.Serialize(const_cast<ANSICHAR*>(StringCast<ANSICHAR>(*CLRF).Get()), CLRF.Len());
+
+		// Empty line between form-data header and content **IS** important
+		Writer.Serialize(const_cast<ANSICHAR*>(StringCast<ANSICHAR>(*CLRF).Get()), CLRF.Len());
+
+		FString sectionData = Field.Value->AsString();
+		Writer.Serialize(const_cast<ANSICHAR*>(StringCast<ANSICHAR>(*sectionData).Get()), sectionData.Len());
+	}
+
+	// The file field itself is encoded once per content and shared by every report attaching it
+	Writer.Serialize(const_cast<ANSICHAR*>(StringCast<ANSICHAR>(*FormStartBoundary).Get()), FormStartBoundary.Len());
+	Writer.Close();
+
+	const FCodecksUploadSection FileSection = File.SharedSection ? File.SharedSection.ToSharedRef() : FCodecksAttachmentCache::Get().FindOrEncode(File);
+
+	FString FormEndBoundary = CLRF + Dash + FormBoundary + Dash + CLRF;
+	TArray64<uint8> FormEnd(reinterpret_cast<const uint8*>(StringCast<ANSICHAR>(*FormEndBoundary).Get()), FormEndBoundary.Len());
+
+	return MakeShared<FCodecksUploadArchive, ESPMode::ThreadSafe>(MoveTemp(Bytes), FileSection, MoveTemp(FormEnd));
+}
+
 void UCodecksUserReportRequest::UploadAttachments(const TArray<TSharedPtr<FJsonValue>>* UploadUrls, const TFunction<void(UCodecksUserReportRequest* Request)>& UpdateCall, const TFunction<void()>& OnComplete)
 {
 	// Schedule onto taskgraph, to not block any execution
@@ -277,6 +403,24 @@ void UCodecksUserReportRequest::UploadAttachments(const TArray<TSharedPtr<FJsonV
 
 		UE::Tasks::FPipe UploadPipe(UE_SOURCE_LOCATION);
 
+		// Lazy attachments are only built now that the server accepted the report, all of them in parallel
+		TMap<FString, UE::Tasks::TTask<TSharedPtr<const FCodecksAttachedFile, ESPMode::ThreadSafe>>> ProvidedFiles;
+		if (UploadUrls)
+		{
+			for (const TSharedPtr<FJsonValue>& UploadUrl : *UploadUrls)
+			{
+				const FString UploadFilename = UploadUrl->AsObject()->GetStringField("fileName");
+
+				const TSharedPtr<const FCodecksAttachedFile, ESPMode::ThreadSafe> AttachedFile = Attachments.FindByFilename(UploadFilename);
+				if (AttachedFile && AttachedFile->IsLazy() && !ProvidedFiles.Contains(UploadFilename))
+				{
+					ProvidedFiles.Add(UploadFilename, UE::Tasks::Launch(TEXT("Codecks_ProvideAttachment"), [AttachedFile]() {
+						return FCodecksAttachmentList::Provide(AttachedFile.ToSharedRef());
+					}));
+				}
+			}
+		}
+
 		if (UploadUrls)
 		{
 			for (const TSharedPtr<FJsonValue>& UploadUrl : *UploadUrls)
@@ -285,22 +429,24 @@ void UCodecksUserReportRequest::UploadAttachments(const TArray<TSharedPtr<FJsonV
 
 				const FString UploadFilename = UploadObject->GetStringField("fileName");
 				const FString UploadURL = UploadObject->GetStringField("url");
+				FCodecksConnectionPrewarmer::Get().NoteUploadUrl(UploadURL);
 
 				// Those get copied to the final request
 				const TSharedPtr<FJsonObject> UploadMetaFields = UploadObject->GetObjectField("fields");
 
-				// Has data for file?
-				if (FAttachedFile* AttachedFile = AttachedFiles.FindByPredicate([&UploadFilename](const FAttachedFile& A) { return A.Filename.Compare(UploadFilename) == 0; }))
+				TSharedPtr<const FCodecksAttachedFile, ESPMode::ThreadSafe> AttachedFile = Attachments.FindByFilename(UploadFilename);
+				if (UE::Tasks::TTask<TSharedPtr<const FCodecksAttachedFile, ESPMode::ThreadSafe>>* ProvidedFile = ProvidedFiles.Find(UploadFilename))
 				{
-					// Proceed building multipart/form-data
-					FString CLRF("\r\n");
-					FString Dash("--");
-
-					TArray<uint8> Bytes;
-					TArray<uint8>::SizeType EstimatedSize = 64;
-					FMemoryWriter Writer(Bytes, false, false);
-					Writer.Seek(0);
+					AttachedFile = ProvidedFile->GetResult();
+					if (!AttachedFile)
+					{
+						UE_LOG(LogCodecksUnreal, Warning, TEXT("Attachment provider for %s produced no data, skipping upload..."), *UploadFilename);
+					}
+				}
 
+				// Has data for file?
+				if (AttachedFile)
+				{
 					const FString FormBoundary = FString::FromInt(FDateTime::Now().GetTicks());
 
 					// Header
@@ -309,71 +455,30 @@ void UCodecksUserReportRequest::UploadAttachments(const TArray<TSharedPtr<FJsonV
 					UploadRequest->SetURL(UploadURL);
 					UploadRequest->SetHeader("Content-Type", "multipart/form-data; boundary=" + FormBoundary);
 
-					FString FormStartBoundary = CLRF + Dash + FormBoundary + CLRF;
-
-					// Set all meta fields according to AWS
-
 					// Add content-type field dynamically as it is not part of metafields
 					UploadMetaFields->Values.Add("Content-Type", MakeShared<FJsonValueString>(AttachedFile->ContentType));
-					{
-						for (TTuple<FString, TSharedPtr<FJsonValue>> Field : UploadMetaFields->Values)
-						{
-							Writer.Serialize(const_cast<ANSICHAR*>(StringCast<ANSICHAR>(*FormStartBoundary).Get()), FormStartBoundary.Len());
-
-							FString header("Content-Disposition: form-data; name=\"" + Field.Key + "\"");
-							Writer.Serialize(const_cast<ANSICHAR*>(StringCast<ANSICHAR>(*header).Get()), header.Len());
-							Writer.Serialize(const_cast<ANSICHAR*>(StringCast<ANSICHAR>(*CLRF).Get()), CLRF.Len());
-
-							// Also add content-type here, because you have to for S3
-							FString ContentType = "Content-Type: text/plain; encoding=utf8";
-							Writer.Serialize(const_cast<ANSICHAR*>(StringCast<ANSICHAR>(*ContentType).Get()), ContentType.Len());
-							Writer.Serialize(const_cast<ANSICHAR*>(StringCast<ANSICHAR>(*CLRF).Get()), CLRF.Len());
-
-							// Empty line between form-data header and content **IS** important
-							Writer.Serialize(const_cast<ANSICHAR*>(StringCast<ANSICHAR>(*CLRF).Get()), CLRF.Len());
-
-							FString sectionData = Field.Value->AsString();
-							Writer.Serialize(const_cast<ANSICHAR*>(StringCast<ANSICHAR>(*sectionData).Get()), sectionData.Len());
-						}
-					}
-
-					// Serialize binary data from file
-					{
-						Writer.Serialize(const_cast<ANSICHAR*>(StringCast<ANSICHAR>(*FormStartBoundary).Get()), FormStartBoundary.Len());
 
-						// Format the file the way S3 wants it (in a form, with the file contents being a field called "file")
-						const FString FileHeader("Content-Disposition: form-data; name=\"file\"; filename=\"" + AttachedFile->Filename + "\"");
-						Writer.Serialize(const_cast<ANSICHAR*>(StringCast<ANSICHAR>(*FileHeader).Get()), FileHeader.Len());
-						Writer.Serialize(const_cast<ANSICHAR*>(StringCast<ANSICHAR>(*CLRF).Get()), CLRF.Len());
-
-						FString ContentType("Content-Type: " + AttachedFile->ContentType);
-						Writer.Serialize(const_cast<ANSICHAR*>(StringCast<ANSICHAR>(*ContentType).Get()), ContentType.Len());
-						Writer.Serialize(const_cast<ANSICHAR*>(StringCast<ANSICHAR>(*CLRF).Get()), CLRF.Len());
-
-						// Empty line between form-data header and content **IS** important
-						Writer.Serialize(const_cast<ANSICHAR*>(StringCast<ANSICHAR>(*CLRF).Get()), CLRF.Len());
-
-						Writer.Serialize(AttachedFile->Binary.GetData(), AttachedFile->Binary.Num());
-					}
-
-					FString FormEndBoundary = CLRF + Dash + FormBoundary + Dash + CLRF;
-					Writer.Serialize(const_cast<ANSICHAR*>(StringCast<ANSICHAR>(*FormEndBoundary).Get()), FormEndBoundary.Len());
-
-					Writer.Close();
-
-					UploadRequest->SetContent(Bytes);
+					UploadRequest->SetContentFromStream(MakeUploadBody(*AttachedFile, *UploadMetaFields, FormBoundary));
 					TotalBytesToSend += UploadRequest->GetContentLength();
 
 					auto UploadFile = [this, UploadRequest, UploadFilename]() {
 						UE::Tasks::FTaskEvent WaitForUpload(UE_SOURCE_LOCATION);
 
 						UploadRequest->OnProcessRequestComplete().BindLambda([&WaitForUpload, UploadFilename, this](FHttpRequestPtr Request, FHttpResponsePtr Response, bool bConnectedSuccessfully) {
-							UE_LOG(LogCodecksUnreal, Log, TEXT("Uploading %s complete..."), *UploadFilename);
-							if (Response->GetResponseCode() > 300)
+							if (!bConnectedSuccessfully || !Response.IsValid())
+							{
+								UE_LOG(LogCodecksUnreal, Warning, TEXT("Uploading %s failed, no connection..."), *UploadFilename);
+								Fail(CodecksRequestErrors::NoConnection);
+							}
+							else if (Response->GetResponseCode() > 300)
 							{
 								UE_LOG(LogCodecksUnreal, Warning, TEXT("%d"), Response->GetResponseCode());
 								UE_LOG(LogCodecksUnreal, Warning, TEXT("%s"), *Response->GetContentAsString());
 							}
+							else
+							{
+								UE_LOG(LogCodecksUnreal, Log, TEXT("Uploading %s complete..."), *UploadFilename);
+							}
 
 							WaitForUpload.Trigger();
 							TotalBytesSent += Request->GetContentLength();
@@ -394,6 +499,9 @@ void UCodecksUserReportRequest::UploadAttachments(const TArray<TSharedPtr<FJsonV
 						FFileHelper::SaveArrayToFile(Bytes, *Testfile);
 #endif // DebugCodecksUploadAsFile
 
+						// Waits here on the worker until earlier uploads are paid off, the HTTP thread reading the body is shared by the whole process
+						FCodecksBandwidthLimiter::Get().Charge(UploadRequest->GetContentLength());
+
 						UploadRequest->ProcessRequest();
 						WaitForUpload.Wait();
 					};
@@ -2,6 +2,10 @@
 
 #include "Settings/CodecksSettings.h"
 
+#include "Memory/CodecksBufferPool.h"
+#include "Network/CodecksBandwidthLimiter.h"
+#include "Requests/CodecksAttachmentCache.h"
+
 UCodecksSettings::UCodecksSettings()
 {
 	CategoryName = "Plugins";
@@ -10,3 +14,49 @@ UCodecksSettings::UCodecksSettings()
 	CodecksApiURL = "https://api.codecks.io";
 }
 
+FCodecksPerformanceWatchdog::FConfig UCodecksSettings::GetPerformanceWatchdogConfig() const
+{
+	FCodecksPerformanceWatchdog::FConfig Config;
+	Config.HitchThresholdMs = HitchThreshold;
+	Config.TickBudgetMs = TickBudget;
+	Config.BudgetWindowFrames = TickBudgetWindowFrames;
+	Config.MinSecondsBetweenReports = MinSecondsBetweenPerformanceReports;
+	Config.MaxReportsPerMap = MaxPerformanceReportsPerMap;
+	return Config;
+}
+
+FCodecksLowMemoryReporter::FConfig UCodecksSettings::GetLowMemoryReportConfig() const
+{
+	FCodecksLowMemoryReporter::FConfig Config;
+	Config.ThresholdBytes = static_cast<uint64>(LowMemoryThreshold) * 1024 * 1024;
+	Config.ReserveBytes = LowMemoryReserve * 1024;
+	Config.MinSecondsBetweenReports = MinSecondsBetweenLowMemoryReports;
+	return Config;
+}
+
+FCodecksReplayRecorder::FConfig UCodecksSettings::GetReplayRecorderConfig() const
+{
+	FCodecksReplayRecorder::FConfig Config;
+	Config.BufferSeconds = ReplayBufferSeconds;
+	Config.MemoryCapBytes = static_cast<int64>(ReplayBufferMemoryCap) * 1024 * 1024;
+	Config.CheckpointInterval = ReplayCheckpointInterval;
+	return Config;
+}
+
+#if WITH_EDITOR
+void UCodecksSettings::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	ApplyUploadBandwidth();
+	FCodecksBufferPool::Get().SetBudget(static_cast<int64>(BufferPoolBudget) * 1024 * 1024);
+	FCodecksAttachmentCache::Get().SetBudget(static_cast<int64>(AttachmentCacheBudget) * 1024 * 1024);
+}
+#endif
+
+void UCodecksSettings::ApplyUploadBandwidth() const
+{
+	FCodecksBandwidthLimiter& Limiter = FCodecksBandwidthLimiter::Get();
+	Limiter.ConfigureAdaptive(AdaptiveLatencyTolerance, AdaptivePacketLossTolerance, AdaptiveMinUploadBandwidth);
+	Limiter.Configure(UploadBandwidthLimit, bAdaptiveUploadBandwidth);
+}
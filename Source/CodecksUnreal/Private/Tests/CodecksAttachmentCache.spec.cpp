@@ -0,0 +1,173 @@
+// Copyright(C) battyRabbit UG (limited liability). All Rights Reserved.
+
+#include <CoreMinimal.h>
+
+#include "Memory/CodecksBufferPool.h"
+#include "Network/CodecksBandwidthLimiter.h"
+#include "Requests/CodecksAttachmentCache.h"
+#include "Requests/CodecksAttachments.h"
+#include "Requests/CodecksUserReportRequest.h"
+#include "Settings/CodecksSettings.h"
+
+#include <Dom/JsonObject.h>
+
+BEGIN_DEFINE_SPEC(FCodecksAttachmentCacheSpec, "CodecksUnreal.AttachmentCache", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+	TUniquePtr<FCodecksAttachmentCache> Cache;
+
+	static FCodecksAttachedFile MakeFile(const FString& Filename, int64 Size, uint8 Fill)
+	{
+		FCodecksAttachedFile File;
+		File.Filename = Filename;
+		File.ContentType = TEXT("text/plain");
+		File.Binary.Init(Fill, Size);
+		return File;
+	}
+
+	/** Content is only kept on its second sighting */
+	FCodecksUploadSection Admit(const FCodecksAttachedFile& File)
+	{
+		Cache->FindOrEncode(File);
+		return Cache->FindOrEncode(File);
+	}
+END_DEFINE_SPEC(FCodecksAttachmentCacheSpec)
+
+void FCodecksAttachmentCacheSpec::Define()
+{
+	BeforeEach([this]
+	{
+		Cache = MakeUnique<FCodecksAttachmentCache>();
+		Cache->SetBudget(4 * 1024 * 1024);
+	});
+
+	Describe("Lookup", [this]()
+	{
+		It("Admits content only on its second sighting", [this]()
+		{
+			Cache->FindOrEncode(MakeFile(TEXT("screenshot.png"), 1024, 's'));
+			TestEqual("Nothing kept after the first sighting", Cache->GetStats().Entries, 0);
+
+			Cache->FindOrEncode(MakeFile(TEXT("screenshot.png"), 1024, 's'));
+			TestEqual("Kept after the second sighting", Cache->GetStats().Entries, 1);
+			TestEqual("Admitted", Cache->GetStats().Admitted, int64(1));
+		});
+
+		It("Shares the section between identical attachments", [this]()
+		{
+			const FCodecksUploadSection First = Admit(MakeFile(TEXT("build.log"), 1024 * 1024, 'a'));
+			const FCodecksUploadSection Second = Cache->FindOrEncode(MakeFile(TEXT("build.log"), 1024 * 1024, 'a'));
+
+			TestTrue("Same section", &First.Get() == &Second.Get());
+			TestEqual("Hits", Cache->GetStats().Hits, int64(1));
+			TestEqual("Misses", Cache->GetStats().Misses, int64(2));
+		});
+
+		It("Tells apart content and filenames", [this]()
+		{
+			Admit(MakeFile(TEXT("build.log"), 1024, 'a'));
+			Admit(MakeFile(TEXT("build.log"), 1024, 'b'));
+			Admit(MakeFile(TEXT("other.log"), 1024, 'a'));
+
+			TestEqual("Hits", Cache->GetStats().Hits, int64(0));
+			TestEqual("Entries", Cache->GetStats().Entries, 3);
+		});
+
+		It("Encodes the same bytes as without cache", [this]()
+		{
+			const FCodecksAttachedFile File = MakeFile(TEXT("config.ini"), 4096, 'c');
+			TestTrue("Same bytes", *Cache->FindOrEncode(File) == FCodecksAttachmentCache::EncodeSection(File));
+		});
+	});
+
+	Describe("Budget", [this]()
+	{
+		It("Evicts the least recently used section", [this]()
+		{
+			Admit(MakeFile(TEXT("a.bin"), 1536 * 1024, 'a'));
+			Admit(MakeFile(TEXT("b.bin"), 1536 * 1024, 'b'));
+
+			// Touch a, so b is the older one once c pushes the cache over budget
+			Cache->FindOrEncode(MakeFile(TEXT("a.bin"), 1536 * 1024, 'a'));
+			Admit(MakeFile(TEXT("c.bin"), 1536 * 1024, 'c'));
+
+			TestEqual("Evicted", Cache->GetStats().Evicted, int64(1));
+			TestTrue("Stays within budget", Cache->GetStats().CachedBytes <= 4 * 1024 * 1024);
+
+			Cache->FindOrEncode(MakeFile(TEXT("a.bin"), 1536 * 1024, 'a'));
+			TestEqual("a was kept", Cache->GetStats().Hits, int64(2));
+		});
+
+		It("Keeps evicted sections alive while uploading", [this]()
+		{
+			const FCodecksUploadSection Uploading = Admit(MakeFile(TEXT("a.bin"), 1024, 'a'));
+			Cache->Trim();
+
+			TestEqual("Nothing cached", Cache->GetStats().CachedBytes, int64(0));
+			TestTrue("Section still valid", Uploading->Num() > 1024);
+		});
+	});
+
+	Describe("Upload body", [this]()
+	{
+		It("Streams head, shared section and tail in order", [this]()
+		{
+			const FCodecksAttachedFile File = MakeFile(TEXT("build.log"), 10000, 'x');
+			const FCodecksUploadSection Section = Cache->FindOrEncode(File);
+
+			TArray64<uint8> Head;
+			Head.Init('h', 100);
+			TArray64<uint8> Tail;
+			Tail.Init('t', 10);
+
+			FCodecksUploadArchive Archive(TArray64<uint8>(Head), Section, TArray64<uint8>(Tail));
+
+			TArray64<uint8> Expected = Head;
+			Expected.Append(*Section);
+			Expected.Append(Tail);
+			TestEqual("Total size", Archive.TotalSize(), Expected.Num());
+
+			// Odd slice size, so reads cross the part boundaries
+			TArray64<uint8> Read;
+			Read.SetNumUninitialized(Expected.Num());
+			for (int64 Offset = 0; Offset < Read.Num(); Offset += 777)
+			{
+				Archive.Serialize(Read.GetData() + Offset, FMath::Min<int64>(777, Read.Num() - Offset));
+			}
+
+			TestFalse("No error", Archive.IsError());
+			TestTrue("Same bytes", Read == Expected);
+		});
+
+		It("Draws sections that aren't cached from the buffer pool", [this]()
+		{
+			// The report's own upload path, with the process wide cache and pool as configured in a default project
+			FCodecksAttachmentCache::Get().SetBudget(0);
+			FCodecksBufferPool::Get().SetBudget(64 * 1024 * 1024);
+
+			const FCodecksAttachedFile File = MakeFile(TEXT("crash.dmp"), 2 * 1024 * 1024, 'd');
+			FJsonObject FormFields;
+			FormFields.SetStringField(TEXT("key"), TEXT("reports/crash.dmp"));
+
+			UCodecksUserReportRequest::MakeUploadBody(File, FormFields, TEXT("benchmark"));
+			const FCodecksBufferPoolStats WarmedUp = FCodecksBufferPool::Get().GetStats();
+
+			static constexpr int32 NumUploads = 100;
+			for (int32 Upload = 0; Upload < NumUploads; ++Upload)
+			{
+				TestTrue("Body holds the file", UCodecksUserReportRequest::MakeUploadBody(File, FormFields, TEXT("benchmark"))->TotalSize() > File.Binary.Num());
+			}
+
+			const FCodecksBufferPoolStats Uploaded = FCodecksBufferPool::Get().GetStats();
+			TestEqual("No allocations after warm-up", Uploaded.Allocated, WarmedUp.Allocated);
+			TestTrue("Form fields and file were both reused", Uploaded.Reused - WarmedUp.Reused >= 2 * NumUploads);
+			TestEqual("Pooled memory stays the same", Uploaded.PooledBytes, WarmedUp.PooledBytes);
+
+			FCodecksAttachmentCache::Get().SetBudget(static_cast<int64>(GetDefault<UCodecksSettings>()->GetAttachmentCacheBudget()) * 1024 * 1024);
+			FCodecksBufferPool::Get().SetBudget(static_cast<int64>(GetDefault<UCodecksSettings>()->GetBufferPoolBudget()) * 1024 * 1024);
+		});
+	});
+
+	AfterEach([this]
+	{
+		Cache.Reset();
+	});
+}
@@ -0,0 +1,111 @@
+// Copyright(C) battyRabbit UG (limited liability). All Rights Reserved.
+
+#include <CoreMinimal.h>
+
+#include "Network/CodecksBandwidthLimiter.h"
+
+#include <HAL/PlatformTime.h>
+#include <Tasks/Task.h>
+
+BEGIN_DEFINE_SPEC(FCodecksBandwidthLimiterSpec, "CodecksUnreal.BandwidthLimiter", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+	TUniquePtr<FCodecksBandwidthLimiter> Limiter;
+
+	/** Charges the uploads one after another on a worker, Charge doesn't wait on the game thread, and returns the seconds it took */
+	double ChargeOnWorker(int64 UploadSize, int32 NumUploads)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		UE::Tasks::Launch(UE_SOURCE_LOCATION, [this, UploadSize, NumUploads]
+		{
+			for (int32 Upload = 0; Upload < NumUploads; ++Upload)
+			{
+				Limiter->Charge(UploadSize);
+			}
+		}).Wait();
+		return FPlatformTime::Seconds() - StartTime;
+	}
+END_DEFINE_SPEC(FCodecksBandwidthLimiterSpec)
+
+void FCodecksBandwidthLimiterSpec::Define()
+{
+	BeforeEach([this]
+	{
+		Limiter = MakeUnique<FCodecksBandwidthLimiter>();
+		Limiter->ConfigureAdaptive(/*InLatencyTolerance=*/0.05f, /*InPacketLossTolerance=*/0.02f, /*InMinBytesPerSecond=*/1024);
+	});
+
+	Describe("Rate", [this]()
+	{
+		It("Starts the first upload right away", [this]()
+		{
+			Limiter->Configure(32 * 1024, /*bInAdaptive=*/false);
+			TestTrue("No wait", ChargeOnWorker(1024 * 1024, 1) < 0.1);
+		});
+
+		It("Holds uploads to the configured rate", [this]()
+		{
+			Limiter->Configure(32 * 1024, /*bInAdaptive=*/false);
+
+			// The second upload waits until the first one's 16KB are paid off at 32KB/s, which takes half a second
+			const double Seconds = ChargeOnWorker(16 * 1024, 2);
+			AddInfo(FString::Printf(TEXT("Two 16KB uploads at 32KB/s took %.3f s"), Seconds));
+			TestTrue("Waited for the rate", Seconds >= 0.45);
+		});
+
+		It("Pays off whole bytes at rates below four bytes a second", [this]()
+		{
+			Limiter->Configure(3, /*bInAdaptive=*/false);
+
+			const double Seconds = ChargeOnWorker(1, 3);
+			TestTrue("Completes", Seconds < 5.0);
+			TestTrue("Waited for the rate", Seconds >= 0.6);
+		});
+
+		It("Does not wait when unlimited", [this]()
+		{
+			Limiter->Configure(0, /*bInAdaptive=*/false);
+			TestTrue("No wait", ChargeOnWorker(1024 * 1024, 16) < 0.1);
+		});
+	});
+
+	Describe("Adaptive mode", [this]()
+	{
+		It("Backs off on packet loss and recovers afterwards", [this]()
+		{
+			Limiter->Configure(64 * 1024, /*bInAdaptive=*/true);
+
+			Limiter->ReportNetworkConditions(0.03f, 0.1f);
+			TestEqual("Rate halves on congestion", Limiter->GetEffectiveRate(), static_cast<int64>(32 * 1024));
+
+			for (int32 Sample = 0; Sample < 20; ++Sample)
+			{
+				Limiter->ReportNetworkConditions(0.03f, 0.0f);
+			}
+			TestEqual("Rate recovers to the limit", Limiter->GetEffectiveRate(), static_cast<int64>(64 * 1024));
+		});
+
+		It("Backs off on latency spikes but never below the minimum", [this]()
+		{
+			Limiter->Configure(4 * 1024, /*bInAdaptive=*/true);
+
+			Limiter->ReportNetworkConditions(0.03f, 0.0f);
+			for (int32 Sample = 0; Sample < 10; ++Sample)
+			{
+				Limiter->ReportNetworkConditions(0.5f, 0.0f);
+			}
+			TestEqual("Rate stays at the minimum", Limiter->GetEffectiveRate(), static_cast<int64>(1024));
+		});
+
+		It("Ignores samples when not adaptive", [this]()
+		{
+			Limiter->Configure(64 * 1024, /*bInAdaptive=*/false);
+
+			Limiter->ReportNetworkConditions(0.03f, 0.5f);
+			TestEqual("Rate is untouched", Limiter->GetEffectiveRate(), static_cast<int64>(64 * 1024));
+		});
+	});
+
+	AfterEach([this]
+	{
+		Limiter.Reset();
+	});
+}
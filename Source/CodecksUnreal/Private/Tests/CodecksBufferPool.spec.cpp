@@ -0,0 +1,109 @@
+// Copyright(C) battyRabbit UG (limited liability). All Rights Reserved.
+
+#include <CoreMinimal.h>
+
+#include "Memory/CodecksBufferPool.h"
+#include "Network/CodecksBandwidthLimiter.h"
+#include "Requests/CodecksUserReportRequest.h"
+#include "Settings/CodecksSettings.h"
+
+#include <Dom/JsonObject.h>
+
+BEGIN_DEFINE_SPEC(FCodecksBufferPoolSpec, "CodecksUnreal.BufferPool", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+	TUniquePtr<FCodecksBufferPool> Pool;
+
+	TArray<FColor> Screenshot;
+
+	/**
+	 * Runs the buffers of one report through the real paths against the process wide pool,
+	 * a 720p screenshot compressed to png and the multipart body uploading it.
+	 */
+	void SimulateReport()
+	{
+		FCodecksAttachedFile File;
+		File.Filename = TEXT("screenshot.png");
+		File.ContentType = TEXT("image/png");
+		File.Binary = UCodecksUserReportRequest::CompressScreenshot(1280, 720, UCodecksUserReportRequest::CopyScreenshotPixels(Screenshot));
+
+		FJsonObject FormFields;
+		FormFields.SetStringField(TEXT("key"), TEXT("reports/screenshot.png"));
+		FormFields.SetStringField(TEXT("Content-Type"), File.ContentType);
+
+		// Dropping the body hands its pooled part back, like the HTTP layer does once the upload finished
+		const TSharedRef<FCodecksUploadArchive, ESPMode::ThreadSafe> Body = UCodecksUserReportRequest::MakeUploadBody(File, FormFields, TEXT("benchmark"));
+		TestTrue("Body holds the png", Body->TotalSize() > File.Binary.Num());
+	}
+END_DEFINE_SPEC(FCodecksBufferPoolSpec)
+
+void FCodecksBufferPoolSpec::Define()
+{
+	BeforeEach([this]
+	{
+		Pool = MakeUnique<FCodecksBufferPool>();
+		Pool->SetBudget(64 * 1024 * 1024);
+
+		FCodecksBufferPool::Get().SetBudget(64 * 1024 * 1024);
+
+		// Some structure, so the png isn't trivially small
+		Screenshot.SetNumUninitialized(1280 * 720);
+		for (int32 Pixel = 0; Pixel < Screenshot.Num(); ++Pixel)
+		{
+			Screenshot[Pixel] = FColor(static_cast<uint8>(Pixel % 1280), static_cast<uint8>(Pixel / 1280), 128);
+		}
+	});
+
+	Describe("Size classes", [this]()
+	{
+		It("Hands out at least the requested capacity", [this]()
+		{
+			for (const int64 Capacity : {int64(1), int64(4096), int64(4097), int64(3 * 1024 * 1024)})
+			{
+				TArray64<uint8> Buffer = Pool->Acquire(Capacity);
+				TestTrue(FString::Printf(TEXT("Capacity for %lld"), Capacity), Buffer.Max() >= Capacity);
+				TestEqual("Buffer is empty", Buffer.Num(), int64(0));
+				Pool->Release(MoveTemp(Buffer));
+			}
+		});
+
+		It("Drops buffers over budget", [this]()
+		{
+			Pool->SetBudget(1024 * 1024);
+
+			TArray64<uint8> Buffer = Pool->Acquire(2 * 1024 * 1024);
+			Pool->Release(MoveTemp(Buffer));
+
+			TestEqual("Buffer was dropped", Pool->GetStats().Dropped, int64(1));
+			TestEqual("Nothing pooled", Pool->GetStats().PooledBytes, int64(0));
+		});
+	});
+
+	Describe("Soak", [this]()
+	{
+		It("Allocations stay flat after warm-up", [this]()
+		{
+			// Twice, the attachment cache (if enabled) only keeps content on its second sighting
+			SimulateReport();
+			SimulateReport();
+			const FCodecksBufferPoolStats WarmedUp = FCodecksBufferPool::Get().GetStats();
+
+			static constexpr int32 NumReports = 100;
+			for (int32 Report = 0; Report < NumReports; ++Report)
+			{
+				SimulateReport();
+			}
+
+			const FCodecksBufferPoolStats Soaked = FCodecksBufferPool::Get().GetStats();
+			TestEqual("No allocations after warm-up", Soaked.Allocated, WarmedUp.Allocated);
+			TestTrue("Every report drew from the pool", Soaked.Reused - WarmedUp.Reused >= 2 * NumReports);
+			TestEqual("Pooled memory stays the same", Soaked.PooledBytes, WarmedUp.PooledBytes);
+		});
+	});
+
+	AfterEach([this]
+	{
+		Pool.Reset();
+		Screenshot.Empty();
+
+		FCodecksBufferPool::Get().SetBudget(static_cast<int64>(GetDefault<UCodecksSettings>()->GetBufferPoolBudget()) * 1024 * 1024);
+	});
+}
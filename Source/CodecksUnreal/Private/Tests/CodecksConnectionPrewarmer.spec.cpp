@@ -0,0 +1,258 @@
+// Copyright(C) battyRabbit UG (limited liability). All Rights Reserved.
+
+#include <CoreMinimal.h>
+
+#include "Network/CodecksConnectionPrewarmer.h"
+
+#include <Containers/Ticker.h>
+#include <HAL/PlatformTime.h>
+#include <HttpModule.h>
+#include <Interfaces/IHttpRequest.h>
+#include <Interfaces/IHttpResponse.h>
+#include <Sockets.h>
+#include <SocketSubsystem.h>
+#include <String/Find.h>
+
+/**
+ * Local stand-in for the create-report endpoint, answering every request like the api does for a report without files.
+ * Keeps connections alive, otherwise there would be nothing to pre-warm. Only owns its own listen socket, so tests
+ * can start and stop it without touching anything else listening in the process.
+ * Holds back the first answer on every new connection, standing in for the DNS lookup and TLS handshake of the real
+ * host, which loopback doesn't have. Without it cold and warm differ by far less than the timer noise.
+ */
+class FCodecksStandInServer
+{
+public:
+	~FCodecksStandInServer() { Stop(); }
+
+	/** @param InSetupDelaySeconds How long a new connection waits before its first request is answered */
+	bool Start(uint32 Port, double InSetupDelaySeconds);
+	void Stop();
+
+private:
+	struct FConnection
+	{
+		FSocket* Socket = nullptr;
+		TArray<uint8> Received;
+		double ReadyTime = 0.0;
+	};
+
+	bool Tick(float DeltaTime);
+
+	/** Answers every complete request in Received, returns false once the connection is gone */
+	static bool Serve(FConnection& Connection);
+
+	FSocket* Listener = nullptr;
+	TArray<FConnection> Connections;
+	double SetupDelaySeconds = 0.0;
+	FTSTicker::FDelegateHandle TickHandle;
+};
+
+bool FCodecksStandInServer::Start(uint32 Port, double InSetupDelaySeconds)
+{
+	SetupDelaySeconds = InSetupDelaySeconds;
+
+	ISocketSubsystem* SocketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+
+	const TSharedRef<FInternetAddr> Address = SocketSubsystem->CreateInternetAddr();
+	Address->SetLoopbackAddress();
+	Address->SetPort(Port);
+
+	Listener = SocketSubsystem->CreateSocket(NAME_Stream, TEXT("CodecksStandInServer"), Address->GetProtocolType());
+	if (!Listener || !Listener->SetReuseAddr() || !Listener->SetNonBlocking() || !Listener->Bind(*Address) || !Listener->Listen(8))
+	{
+		Stop();
+		return false;
+	}
+
+	TickHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FCodecksStandInServer::Tick));
+	return true;
+}
+
+void FCodecksStandInServer::Stop()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(TickHandle);
+	TickHandle.Reset();
+
+	ISocketSubsystem* SocketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+	for (FConnection& Connection : Connections)
+	{
+		Connection.Socket->Close();
+		SocketSubsystem->DestroySocket(Connection.Socket);
+	}
+	Connections.Reset();
+
+	if (Listener)
+	{
+		Listener->Close();
+		SocketSubsystem->DestroySocket(Listener);
+		Listener = nullptr;
+	}
+}
+
+bool FCodecksStandInServer::Tick(float /*DeltaTime*/)
+{
+	bool bHasPendingConnection = false;
+	while (Listener->HasPendingConnection(bHasPendingConnection) && bHasPendingConnection)
+	{
+		FSocket* Socket = Listener->Accept(TEXT("CodecksStandInConnection"));
+		if (!Socket)
+		{
+			break;
+		}
+
+		Socket->SetNonBlocking();
+		Connections.Add({Socket, {}, FPlatformTime::Seconds() + SetupDelaySeconds});
+	}
+
+	const double Now = FPlatformTime::Seconds();
+	for (int32 Index = Connections.Num() - 1; Index >= 0; --Index)
+	{
+		if (Now < Connections[Index].ReadyTime)
+		{
+			continue;
+		}
+
+		if (!Serve(Connections[Index]))
+		{
+			Connections[Index].Socket->Close();
+			ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(Connections[Index].Socket);
+			Connections.RemoveAtSwap(Index);
+		}
+	}
+
+	return true;
+}
+
+bool FCodecksStandInServer::Serve(FConnection& Connection)
+{
+	uint8 Buffer[4096];
+	int32 BytesRead = 0;
+	do
+	{
+		// A stream socket reports a closed connection as failure, no data yet as success with nothing read
+		if (!Connection.Socket->Recv(Buffer, UE_ARRAY_COUNT(Buffer), BytesRead))
+		{
+			return false;
+		}
+		Connection.Received.Append(Buffer, BytesRead);
+	}
+	while (BytesRead > 0);
+
+	const FAnsiStringView Received(reinterpret_cast<const ANSICHAR*>(Connection.Received.GetData()), Connection.Received.Num());
+	const int32 HeaderEnd = UE::String::FindFirst(Received, "\r\n\r\n");
+	if (HeaderEnd == INDEX_NONE)
+	{
+		return true;
+	}
+
+	const FString Header(HeaderEnd, Received.GetData());
+
+	int32 ContentLength = 0;
+	TArray<FString> Lines;
+	Header.ParseIntoArrayLines(Lines);
+	for (const FString& Line : Lines)
+	{
+		if (Line.StartsWith(TEXT("Content-Length:")))
+		{
+			ContentLength = FCString::Atoi(*Line.RightChop(15).TrimStart());
+		}
+	}
+
+	const int32 RequestSize = HeaderEnd + 4 + ContentLength;
+	if (Connection.Received.Num() < RequestSize)
+	{
+		return true;
+	}
+	Connection.Received.RemoveAt(0, RequestSize);
+
+	// The pre-warm HEAD must not get a body, it would be read as the start of the next response
+	const FAnsiStringView Body = Header.StartsWith(TEXT("HEAD ")) ? FAnsiStringView() : FAnsiStringView("{\"uploadUrls\":[]}");
+	const FString Response = FString::Printf(TEXT("HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: %d\r\nConnection: keep-alive\r\n\r\n%s"),
+		Body.Len(), *FString(Body));
+
+	const FTCHARToUTF8 ResponseBytes(*Response);
+	int32 BytesSent = 0;
+	return Connection.Socket->Send(reinterpret_cast<const uint8*>(ResponseBytes.Get()), ResponseBytes.Length(), BytesSent);
+}
+
+BEGIN_DEFINE_SPEC(FCodecksConnectionPrewarmerSpec, "CodecksUnreal.ConnectionPrewarmer", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+	// Separate ports for cold and warm, the connection cache is per host and port
+	static constexpr uint32 ColdPort = 18530;
+	static constexpr uint32 WarmPort = 18531;
+
+	// Roughly a TLS handshake to a distant host
+	static constexpr double SetupDelaySeconds = 0.2;
+
+	TUniquePtr<FCodecksStandInServer> ColdServer;
+	TUniquePtr<FCodecksStandInServer> WarmServer;
+
+	// A host name rather than an address, so the cold report pays for name resolution like a real one does
+	static FString GetUrl(uint32 Port) { return FString::Printf(TEXT("http://localhost:%u/user-report/v1/create-report"), Port); }
+
+	void SendTimedReport(const FString& Url, TFunction<void(double Seconds, bool bSucceeded)> OnComplete);
+END_DEFINE_SPEC(FCodecksConnectionPrewarmerSpec)
+
+void FCodecksConnectionPrewarmerSpec::SendTimedReport(const FString& Url, TFunction<void(double Seconds, bool bSucceeded)> OnComplete)
+{
+	const TSharedRef<IHttpRequest> Request = FHttpModule::Get().CreateRequest();
+	Request->SetVerb("POST");
+	Request->SetURL(Url);
+	Request->SetHeader("Content-Type", "application/json");
+	Request->SetContentAsString(TEXT("{\"content\":\"benchmark\",\"fileNames\":[]}"));
+
+	const double StartTime = FPlatformTime::Seconds();
+	Request->OnProcessRequestComplete().BindLambda([StartTime, OnComplete](FHttpRequestPtr /*Request*/, FHttpResponsePtr Response, bool bConnectedSuccessfully) {
+		OnComplete(FPlatformTime::Seconds() - StartTime, bConnectedSuccessfully && Response.IsValid() && Response->GetResponseCode() == 200);
+	});
+	Request->ProcessRequest();
+}
+
+void FCodecksConnectionPrewarmerSpec::Define()
+{
+	Describe("Origin", [this]()
+	{
+		It("Strips path and query but keeps the port", [this]()
+		{
+			TestEqual("Api url", FCodecksConnectionPrewarmer::GetOrigin("https://api.codecks.io/user-report/v1/create-report?token=abc"), FString("https://api.codecks.io/"));
+			TestEqual("Port is kept", FCodecksConnectionPrewarmer::GetOrigin("http://127.0.0.1:18530/foo"), FString("http://127.0.0.1:18530/"));
+			TestEqual("Bare host", FCodecksConnectionPrewarmer::GetOrigin("https://storage.example.com"), FString("https://storage.example.com/"));
+			TestEqual("Relative url", FCodecksConnectionPrewarmer::GetOrigin("user-report/v1"), FString());
+		});
+	});
+
+	Describe("Benchmark", [this]()
+	{
+		BeforeEach([this]
+		{
+			ColdServer = MakeUnique<FCodecksStandInServer>();
+			WarmServer = MakeUnique<FCodecksStandInServer>();
+			TestTrue("Cold server listening", ColdServer->Start(ColdPort, SetupDelaySeconds));
+			TestTrue("Warm server listening", WarmServer->Start(WarmPort, SetupDelaySeconds));
+		});
+
+		LatentIt("Cold versus pre-warmed first report", FTimespan::FromSeconds(30), [this](const FDoneDelegate& Done)
+		{
+			SendTimedReport(GetUrl(ColdPort), [this, Done](double ColdSeconds, bool bColdSucceeded) {
+				TestTrue("Cold report reached the stand-in server", bColdSucceeded);
+
+				FCodecksConnectionPrewarmer::Get().PrewarmUrl(GetUrl(WarmPort), FSimpleDelegate::CreateLambda([this, Done, ColdSeconds]() {
+					SendTimedReport(GetUrl(WarmPort), [this, Done, ColdSeconds](double WarmSeconds, bool bWarmSucceeded) {
+						TestTrue("Warm report reached the stand-in server", bWarmSucceeded);
+
+						// A single sample on a shared test machine, so the numbers are reported rather than compared
+						AddInfo(FString::Printf(TEXT("First report latency with %.0f ms connection setup: cold %.2f ms, pre-warmed %.2f ms"),
+							SetupDelaySeconds * 1000.0, ColdSeconds * 1000.0, WarmSeconds * 1000.0));
+						Done.Execute();
+					});
+				}));
+			});
+		});
+
+		AfterEach([this]
+		{
+			ColdServer.Reset();
+			WarmServer.Reset();
+		});
+	});
+}
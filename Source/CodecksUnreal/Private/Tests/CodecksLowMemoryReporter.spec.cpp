@@ -0,0 +1,44 @@
+// Copyright(C) battyRabbit UG (limited liability). All Rights Reserved.
+
+#include <CoreMinimal.h>
+
+#include "Diagnostics/CodecksLowMemoryReporter.h"
+
+BEGIN_DEFINE_SPEC(FCodecksLowMemoryReporterSpec, "CodecksUnreal.LowMemoryReport", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+	TUniquePtr<FCodecksLowMemoryReporter> Reporter;
+END_DEFINE_SPEC(FCodecksLowMemoryReporterSpec)
+
+void FCodecksLowMemoryReporterSpec::Define()
+{
+	BeforeEach([this]
+	{
+		FCodecksLowMemoryReporter::FConfig Config;
+		Config.ReserveBytes = 0;
+		// Not hooked into memory trim warnings or the ticker, so this never files a real report
+		Config.bRegisterHooks = false;
+		Reporter = MakeUnique<FCodecksLowMemoryReporter>(Config);
+	});
+
+	Describe("Snapshot", [this]()
+	{
+		It("Is written into the reserved buffer with all sections", [this]()
+		{
+			const ANSICHAR* ReservedBuffer = Reporter->GetSnapshot().GetData();
+
+			const int32 Length = Reporter->WriteSnapshot();
+			TestTrue("Snapshot is not empty", Length > 0);
+			TestTrue("Snapshot fits the reserved buffer", Length < FCodecksLowMemoryReporter::SummaryCapacity);
+			TestEqual("Reserved buffer was not reallocated", Reporter->GetSnapshot().GetData(), ReservedBuffer);
+
+			const FString Snapshot(Length, Reporter->GetSnapshot().GetData());
+			TestTrue("Has memory stats", Snapshot.Contains(TEXT("[memory]")));
+			TestTrue("Has top classes", Snapshot.Contains(TEXT("[uobject_classes]")));
+			TestTrue("Has streaming state", Snapshot.Contains(TEXT("[streaming]")));
+		});
+	});
+
+	AfterEach([this]
+	{
+		Reporter.Reset();
+	});
+}
@@ -0,0 +1,140 @@
+// Copyright(C) battyRabbit UG (limited liability). All Rights Reserved.
+
+#include <CoreMinimal.h>
+
+#include "Diagnostics/CodecksPerformanceWatchdog.h"
+#include "Requests/CodecksUserReportRequest.h"
+
+BEGIN_DEFINE_SPEC(FCodecksPerformanceWatchdogSpec, "CodecksUnreal.PerformanceWatchdog", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+	TUniquePtr<FCodecksPerformanceWatchdog> Watchdog;
+
+	void MakeWatchdog(int32 BudgetWindowFrames, float MinSecondsBetweenReports, int32 MaxReportsPerMap)
+	{
+		// Frames are fed by hand, nothing is hooked into the engine and no report gets filed
+		FCodecksPerformanceWatchdog::FConfig Config;
+		Config.HitchThresholdMs = 200.0f;
+		Config.TickBudgetMs = 10.0f;
+		Config.BudgetWindowFrames = BudgetWindowFrames;
+		Config.MapLoadGraceSeconds = 5.0f;
+		Config.MinSecondsBetweenReports = MinSecondsBetweenReports;
+		Config.MaxReportsPerMap = MaxReportsPerMap;
+		Config.bRegisterHooks = false;
+		Watchdog = MakeUnique<FCodecksPerformanceWatchdog>(Config);
+	}
+
+	bool RecordHitch(double CurrentTime)
+	{
+		FCodecksPerformanceWatchdog::FDetection Detection;
+		return Watchdog->RecordFrame(300.0f, CurrentTime, Detection);
+	}
+END_DEFINE_SPEC(FCodecksPerformanceWatchdogSpec)
+
+void FCodecksPerformanceWatchdogSpec::Define()
+{
+	Describe("Severity", [this]()
+	{
+		It("Grows with the overrun", [this]()
+		{
+			TestTrue("Slightly over is low", FCodecksPerformanceWatchdog::GetSeverityForOverrun(1.5f) == ECodecksUserReportSeverity::Low);
+			TestTrue("Twice is high", FCodecksPerformanceWatchdog::GetSeverityForOverrun(2.0f) == ECodecksUserReportSeverity::High);
+			TestTrue("Just below four times is high", FCodecksPerformanceWatchdog::GetSeverityForOverrun(3.9f) == ECodecksUserReportSeverity::High);
+			TestTrue("Four times is critical", FCodecksPerformanceWatchdog::GetSeverityForOverrun(4.0f) == ECodecksUserReportSeverity::Critical);
+		});
+	});
+
+	Describe("Budget window", [this]()
+	{
+		BeforeEach([this]
+		{
+			MakeWatchdog(4, 0.0f, 100);
+		});
+
+		It("Averages only once the window filled up", [this]()
+		{
+			FCodecksPerformanceWatchdog::FDetection Detection;
+			for (int32 Frame = 0; Frame < 3; ++Frame)
+			{
+				TestFalse("Within budget", Watchdog->RecordFrame(50.0f, 100.0, Detection));
+			}
+			TestEqual("No average yet", Watchdog->GetBudgetWindowAverageMs(), 0.0f);
+		});
+
+		It("Rolls frames out of the window", [this]()
+		{
+			FCodecksPerformanceWatchdog::FDetection Detection;
+			for (int32 Frame = 0; Frame < 4; ++Frame)
+			{
+				TestFalse("Within budget", Watchdog->RecordFrame(5.0f, 100.0, Detection));
+			}
+			TestEqual("Average of the window", Watchdog->GetBudgetWindowAverageMs(), 5.0f);
+
+			TestFalse("One slow frame stays within budget", Watchdog->RecordFrame(20.0f, 100.0, Detection));
+			TestEqual("Oldest frame rolled out", Watchdog->GetBudgetWindowAverageMs(), 8.75f);
+
+			if (TestTrue("Two slow frames overrun the budget", Watchdog->RecordFrame(20.0f, 100.0, Detection)))
+			{
+				TestTrue("Reported as overrun", Detection.Summary.Contains(TEXT("Tick budget overrun")));
+				TestEqual("Ratio to the budget", Detection.Ratio, 1.25f);
+			}
+		});
+
+		It("Stays exact when the ring wraps around", [this]()
+		{
+			FCodecksPerformanceWatchdog::FDetection Detection;
+			for (int32 Frame = 0; Frame < 3 * FCodecksPerformanceWatchdog::WindowSize + 1; ++Frame)
+			{
+				Watchdog->RecordFrame(Frame % 2 == 0 ? 2.0f : 6.0f, 100.0, Detection);
+			}
+			TestEqual("Average of the last frames", Watchdog->GetBudgetWindowAverageMs(), 4.0f, 0.001f);
+		});
+
+		It("Reports a single hitch above the threshold", [this]()
+		{
+			FCodecksPerformanceWatchdog::FDetection Detection;
+			if (TestTrue("Hitch detected", Watchdog->RecordFrame(300.0f, 100.0, Detection)))
+			{
+				TestTrue("Reported as hitch", Detection.Summary.Contains(TEXT("Hitch")));
+				TestEqual("Ratio to the threshold", Detection.Ratio, 1.5f);
+			}
+		});
+	});
+
+	Describe("Rate limit", [this]()
+	{
+		It("Ignores hitches during the map load grace period", [this]()
+		{
+			MakeWatchdog(4, 0.0f, 100);
+			Watchdog->BeginMap(100.0);
+
+			TestFalse("Within grace period", RecordHitch(101.0));
+			TestTrue("After grace period", RecordHitch(106.0));
+		});
+
+		It("Reports once per map", [this]()
+		{
+			MakeWatchdog(4, 0.0f, 1);
+
+			TestTrue("First report", RecordHitch(100.0));
+			TestFalse("Second report on the same map", RecordHitch(101.0));
+
+			Watchdog->BeginMap(110.0);
+			TestTrue("First report on the next map", RecordHitch(120.0));
+		});
+
+		It("Keeps the global interval across maps", [this]()
+		{
+			MakeWatchdog(4, 300.0f, 100);
+
+			TestTrue("First report", RecordHitch(100.0));
+
+			Watchdog->BeginMap(110.0);
+			TestFalse("Next map within the interval", RecordHitch(120.0));
+			TestTrue("After the interval", RecordHitch(400.0));
+		});
+	});
+
+	AfterEach([this]
+	{
+		Watchdog.Reset();
+	});
+}
@@ -0,0 +1,91 @@
+// Copyright(C) battyRabbit UG (limited liability). All Rights Reserved.
+
+#include <CoreMinimal.h>
+
+#include "Diagnostics/CodecksSystemMetadata.h"
+
+#include <Dom/JsonObject.h>
+#include <Misc/EngineVersion.h>
+#include <Serialization/JsonReader.h>
+#include <Serialization/JsonSerializer.h>
+
+BEGIN_DEFINE_SPEC(FCodecksSystemMetadataSpec, "CodecksUnreal.SystemMetadata", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+	TUniquePtr<FCodecksSystemMetadata> Metadata;
+
+	TSharedPtr<FJsonObject> Parse(const TArray64<uint8>& Serialized)
+	{
+		const FUTF8ToTCHAR Json(reinterpret_cast<const ANSICHAR*>(Serialized.GetData()), static_cast<int32>(Serialized.Num()));
+
+		TSharedPtr<FJsonObject> JsonObject;
+		FJsonSerializer::Deserialize(TJsonReaderFactory<TCHAR>::Create(FString(Json.Length(), Json.Get())), JsonObject);
+		return JsonObject;
+	}
+END_DEFINE_SPEC(FCodecksSystemMetadataSpec)
+
+void FCodecksSystemMetadataSpec::Define()
+{
+	BeforeEach([this]
+	{
+		// Own instance, so custom fields set here don't end up in real reports
+		Metadata = MakeUnique<FCodecksSystemMetadata>();
+	});
+
+	Describe("Serialized block", [this]()
+	{
+		It("Contains the gathered fields and the custom section", [this]()
+		{
+			Metadata->GatherAsync(/*bIncludeCommandLine=*/false);
+			Metadata->SetCustomField(TEXT("region"), TEXT("eu-west"));
+
+			const TSharedPtr<FJsonObject> JsonObject = Parse(*Metadata->GetSerialized());
+			if (!TestTrue("Valid json", JsonObject.IsValid()))
+			{
+				return;
+			}
+
+			for (const TCHAR* Field : {TEXT("project"), TEXT("engineVersion"), TEXT("engineChangelist"), TEXT("buildChangelist"), TEXT("platform"), TEXT("os"), TEXT("cpu"), TEXT("ram")})
+			{
+				TestTrue(FString::Printf(TEXT("Has %s"), Field), JsonObject->HasTypedField<EJson::String>(Field));
+			}
+			TestEqual("Engine version", JsonObject->GetStringField(TEXT("engineVersion")), FEngineVersion::Current().ToString());
+			TestFalse("Command line left out", JsonObject->HasField(TEXT("commandLine")));
+			TestTrue("Has enabled plugins", JsonObject->HasTypedField<EJson::Array>(TEXT("enabledPlugins")));
+
+			const TSharedPtr<FJsonObject>* Custom = nullptr;
+			if (TestTrue("Has custom section", JsonObject->TryGetObjectField(TEXT("custom"), Custom)))
+			{
+				TestEqual("Custom field", (*Custom)->GetStringField(TEXT("region")), FString(TEXT("eu-west")));
+			}
+		});
+
+		It("Contains the command line only when asked to", [this]()
+		{
+			Metadata->GatherAsync(/*bIncludeCommandLine=*/true);
+
+			const TSharedPtr<FJsonObject> JsonObject = Parse(*Metadata->GetSerialized());
+			TestTrue("Has commandLine", JsonObject.IsValid() && JsonObject->HasTypedField<EJson::String>(TEXT("commandLine")));
+		});
+
+		It("Serializes again only after a custom field changed", [this]()
+		{
+			const TSharedRef<const TArray64<uint8>, ESPMode::ThreadSafe> First = Metadata->GetSerialized();
+			TestTrue("Cached while unchanged", &Metadata->GetSerialized().Get() == &First.Get());
+
+			Metadata->SetCustomField(TEXT("slot"), TEXT("3"));
+			const TSharedRef<const TArray64<uint8>, ESPMode::ThreadSafe> Second = Metadata->GetSerialized();
+			TestTrue("Serialized again", &Second.Get() != &First.Get());
+
+			const TSharedPtr<FJsonObject> JsonObject = Parse(*Second);
+			const TSharedPtr<FJsonObject>* Custom = nullptr;
+			if (TestTrue("Has custom section", JsonObject.IsValid() && JsonObject->TryGetObjectField(TEXT("custom"), Custom)))
+			{
+				TestEqual("New custom field", (*Custom)->GetStringField(TEXT("slot")), FString(TEXT("3")));
+			}
+		});
+	});
+
+	AfterEach([this]
+	{
+		Metadata.Reset();
+	});
+}
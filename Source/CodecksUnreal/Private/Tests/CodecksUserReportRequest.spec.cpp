@@ -2,25 +2,20 @@
 
 #include <CoreMinimal.h>
 
+#include "Requests/CodecksAttachmentCache.h"
 #include "Requests/CodecksUserReportRequest.h"
 
-
-// Just here so we don't need to friend / give access to AttachedFiles
-class UCodecksUserReportRequest_Internal : public UCodecksUserReportRequest
-{
-public:
-	using UCodecksUserReportRequest::AttachedFiles;
-};
+#include <Tasks/Task.h>
 
 BEGIN_DEFINE_SPEC(FCodecksUnrealReportRequest, "CodecksUnreal.Attachments", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
-	TObjectPtr<UCodecksUserReportRequest_Internal> Request = nullptr;
+	TObjectPtr<UCodecksUserReportRequest> Request = nullptr;
 END_DEFINE_SPEC(FCodecksUnrealReportRequest)
 
 void FCodecksUnrealReportRequest::Define()
 {
 	BeforeEach([this]
 	{
-		Request = NewObject<UCodecksUserReportRequest_Internal>(GetTransientPackage());
+		Request = NewObject<UCodecksUserReportRequest>(GetTransientPackage());
 	});
 
 	Describe("Attach Files", [this]()
@@ -29,13 +24,114 @@ void FCodecksUnrealReportRequest::Define()
 		{
 			static const FString Filename = "test.log";
 			static const FString Content = TEXT("JBhMAMLMUNLs6uy5cw7iWBoXo3SFI5SP狗ジャパニーズ");
-			Request->AttachFile(Filename, Content);
-			const auto& AttachedFile = Request->AttachedFiles[0];
+			const FCodecksAttachmentHandle Handle = Request->AttachFile(Filename, Content);
+			const auto AttachedFile = Request->GetAttachments().Find(Handle);
 
-			TestEqual("Filename matches", AttachedFile.Filename, Filename);
-			const FString Backported = reinterpret_cast<const TCHAR*>(AttachedFile.Binary.GetData());
+			if (!TestTrue("Attachment found by handle", AttachedFile.IsValid()))
+			{
+				return;
+			}
+
+			TestEqual("Filename matches", AttachedFile->Filename, Filename);
+			const FString Backported = reinterpret_cast<const TCHAR*>(AttachedFile->Binary.GetData());
 			TestEqual("File content matches", Backported, Content);
 		});
+
+		It("Attaching from worker threads keeps every file and its handle", [this]()
+		{
+			static constexpr int32 NumWorkers = 16;
+			TArray<FCodecksAttachmentHandle> Handles;
+			Handles.SetNum(NumWorkers);
+
+			TArray<UE::Tasks::FTask> Tasks;
+			for (int32 Worker = 0; Worker < NumWorkers; ++Worker)
+			{
+				Tasks.Add(UE::Tasks::Launch(UE_SOURCE_LOCATION, [this, Worker, &Handles]() {
+					Handles[Worker] = Request->AttachFile(FString::Printf(TEXT("worker_%d.log"), Worker), FString::FromInt(Worker));
+				}));
+			}
+			UE::Tasks::Wait(Tasks);
+
+			TestEqual("All attachments registered", Request->GetAttachments().Num(), NumWorkers);
+			for (int32 Worker = 0; Worker < NumWorkers; ++Worker)
+			{
+				const auto AttachedFile = Request->GetAttachments().Find(Handles[Worker]);
+				if (TestTrue("Attachment found by handle", AttachedFile.IsValid()))
+				{
+					TestEqual("Handle resolves to its own file", AttachedFile->Filename, FString::Printf(TEXT("worker_%d.log"), Worker));
+				}
+			}
+		});
+	});
+
+	Describe("Lazy attachments", [this]()
+	{
+		It("Are listed in the report without being produced", [this]()
+		{
+			int32 ProviderCalls = 0;
+			Request->SetContent("Lazy report");
+			Request->AttachLazy("memreport.txt", [&ProviderCalls](TArray64<uint8>& OutBinary, FString& OutContentType) {
+				++ProviderCalls;
+				return true;
+			});
+
+			const TSharedPtr<FJsonObject> JsonObject = MakeShared<FJsonObject>();
+			Request->AddRequestData(JsonObject);
+
+			const TArray<TSharedPtr<FJsonValue>>* FileNames = nullptr;
+			if (TestTrue("Has file names", JsonObject->TryGetArrayField("fileNames", FileNames)))
+			{
+				TestTrue("Lazy file name is listed", FileNames->ContainsByPredicate([](const TSharedPtr<FJsonValue>& FileName) { return FileName->AsString() == TEXT("memreport.txt"); }));
+			}
+			TestEqual("Provider was not called", ProviderCalls, 0);
+		});
+
+		It("Produce their data when provided", [this]()
+		{
+			const FCodecksAttachmentHandle Handle = Request->AttachLazy("save.bin", [](TArray64<uint8>& OutBinary, FString& OutContentType) {
+				OutBinary = {1, 2, 3};
+				return true;
+			});
+
+			const auto LazyFile = Request->GetAttachments().Find(Handle);
+			if (!TestTrue("Attachment found by handle", LazyFile.IsValid()))
+			{
+				return;
+			}
+
+			const auto ProvidedFile = FCodecksAttachmentList::Provide(LazyFile.ToSharedRef());
+			if (TestTrue("Provider succeeded", ProvidedFile.IsValid()))
+			{
+				TestEqual("Filename is kept", ProvidedFile->Filename, FString("save.bin"));
+				TestEqual("Data was produced", ProvidedFile->Binary.Num(), static_cast<int64>(3));
+				TestFalse("Provided file is no longer lazy", ProvidedFile->IsLazy());
+			}
+		});
+	});
+
+	Describe("Shared attachments", [this]()
+	{
+		It("Reference the same encoded section from every report", [this]()
+		{
+			FCodecksAttachedFile File;
+			File.Filename = TEXT("build.log");
+			File.ContentType = TEXT("text/plain");
+			File.Binary.Init('b', 4096);
+			const FCodecksSharedAttachment Shared(File);
+
+			UCodecksUserReportRequest* OtherRequest = NewObject<UCodecksUserReportRequest>(GetTransientPackage());
+			const auto First = Request->GetAttachments().Find(Request->AttachShared(Shared));
+			const auto Second = OtherRequest->GetAttachments().Find(OtherRequest->AttachShared(Shared));
+			if (!TestTrue("Attachments found by handle", First.IsValid() && Second.IsValid()))
+			{
+				return;
+			}
+
+			TestEqual("Filename is kept", First->Filename, FString("build.log"));
+			TestTrue("Nothing copied", First->Binary.IsEmpty());
+			TestTrue("Same section", First->SharedSection == Second->SharedSection);
+			TestTrue("Same bytes as encoding it per report", *First->SharedSection == FCodecksAttachmentCache::EncodeSection(File));
+		});
 	});
 
 	AfterEach([this]
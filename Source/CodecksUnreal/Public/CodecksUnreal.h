@@ -4,12 +4,31 @@
 
 #include "CoreMinimal.h"
 
+#include "Diagnostics/CodecksLowMemoryReporter.h"
+#include "Diagnostics/CodecksPerformanceWatchdog.h"
+#include "Diagnostics/CodecksReplayRecorder.h"
+
+#include <Containers/Ticker.h>
+#include <Stats/Stats.h>
+
 class FCodecksUnrealModule : public IModuleInterface
 {
 public:
 	/** IModuleInterface implementation */
 	virtual void StartupModule() override;
 	virtual void ShutdownModule() override;
+
+private:
+	/** Samples the game's net connections and feeds them to the adaptive upload limiter */
+	bool SampleNetworkConditions(float DeltaTime);
+
+	FTSTicker::FDelegateHandle NetworkSampleHandle;
+
+	TUniquePtr<FCodecksPerformanceWatchdog> PerformanceWatchdog;
+	TUniquePtr<FCodecksLowMemoryReporter> LowMemoryReporter;
+	TUniquePtr<FCodecksReplayRecorder> ReplayRecorder;
 };
 
 DECLARE_LOG_CATEGORY_EXTERN(LogCodecksUnreal, Log, All);
+
+DECLARE_STATS_GROUP(TEXT("CodecksUnreal"), STATGROUP_CodecksUnreal, STATCAT_Advanced);
@@ -0,0 +1,88 @@
+// Copyright(C) battyRabbit UG (limited liability). All Rights Reserved.
+
+#pragma once
+
+#include <CoreMinimal.h>
+
+#include <Containers/Ticker.h>
+
+#include <atomic>
+
+class UClass;
+
+/**
+ * Files a report with a compact memory snapshot when the platform warns about low memory.
+ *
+ * Everything the snapshot needs is reserved up front: a fixed text buffer, a fixed class table and the buffer for
+ * the compressed result. On top of that a reserve block is held and released right before the report is built,
+ * giving the allocator headroom for the few small allocations left (http request, compression state). Nothing
+ * grows with the size of the snapshot, so building it doesn't push the process further towards being killed.
+ */
+class CODECKSUNREAL_API FCodecksLowMemoryReporter
+{
+public:
+	static constexpr int32 SummaryCapacity = 32 * 1024;
+	static constexpr int32 ClassTableSize = 4096;
+	static constexpr int32 TopClassCount = 24;
+
+	struct FConfig
+	{
+		/** Free physical memory below this also counts as a warning, 0 only listens to the platform */
+		uint64 ThresholdBytes = 0;
+		/** Released right before building the report */
+		int32 ReserveBytes = 1024 * 1024;
+		float MinSecondsBetweenReports = 600.0f;
+		/** Listens to memory trim warnings and polls free memory. Off lets tests build snapshots without ever filing a report */
+		bool bRegisterHooks = true;
+	};
+
+	explicit FCodecksLowMemoryReporter(const FConfig& InConfig);
+	~FCodecksLowMemoryReporter();
+
+	/**
+	 * Writes the snapshot into the reserved summary buffer.
+	 * @return Length of the snapshot text
+	 */
+	int32 WriteSnapshot();
+
+	TArrayView<const ANSICHAR> GetSnapshot() const { return TArrayView<const ANSICHAR>(Summary.GetData(), SummaryLength); }
+
+private:
+	struct FClassUsage
+	{
+		const UClass* Class;
+		int64 Count;
+		int64 Bytes;
+	};
+
+	/** Memory trim and low memory warnings may arrive on any thread, they only flag the report */
+	void OnLowMemoryWarning();
+	bool Tick(float DeltaTime);
+
+	void FileReport();
+
+	/** Takes the reserve again for the next warning, the report may outlive the reporter hence the weak reference */
+	static void TakeReserve(const TWeakPtr<TArray<uint8>>& WeakReserve, int32 ReserveBytes);
+
+	void WriteMemoryStats();
+	void WriteLLMTags();
+	void WriteTopClasses();
+	void WriteStreamingState();
+
+	void Printf(const ANSICHAR* Format, ...);
+
+	FConfig Config;
+
+	TArray<ANSICHAR> Summary;
+	int32 SummaryLength = 0;
+
+	TArray<uint8> Compressed;
+	TArray<FClassUsage> ClassTable;
+	TSharedRef<TArray<uint8>> Reserve = MakeShared<TArray<uint8>>();
+
+	std::atomic<bool> bLowMemoryWarning{false};
+	double LastReportTime = -DBL_MAX;
+
+	FDelegateHandle MemoryTrimHandle;
+	FTSTicker::FDelegateHandle TickHandle;
+};
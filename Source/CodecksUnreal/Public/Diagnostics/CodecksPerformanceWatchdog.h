@@ -0,0 +1,111 @@
+// Copyright(C) battyRabbit UG (limited liability). All Rights Reserved.
+
+#pragma once
+
+#include <CoreMinimal.h>
+
+#include <Containers/StaticArray.h>
+#include <HAL/CriticalSection.h>
+#include <HAL/Runnable.h>
+
+#include <atomic>
+
+class UWorld;
+
+enum class ECodecksUserReportSeverity : uint8;
+
+/**
+ * Files reports on its own for hitches and tick budget overruns, on clients as well as on dedicated servers.
+ *
+ * Per frame it only reads the game thread's work time (frame time without idle) into a fixed window. A separate
+ * thread checks in on the running frame and grabs the game thread's callstack while a hitch is still going on,
+ * so the report shows what was actually stalling. Reports are rate limited globally and per map.
+ */
+class CODECKSUNREAL_API FCodecksPerformanceWatchdog : public FRunnable
+{
+public:
+	static constexpr int32 WindowSize = 256;
+	static constexpr int32 MaxCallstackDepth = 64;
+
+	struct FConfig
+	{
+		/** A single frame's work time above this is a hitch */
+		float HitchThresholdMs = 200.0f;
+		/** Average work time above this over BudgetWindowFrames is an overrun, 0 derives it from the server tick rate */
+		float TickBudgetMs = 0.0f;
+		int32 BudgetWindowFrames = 60;
+		/** Frames right after a map load are ignored, loading hitches are expected */
+		float MapLoadGraceSeconds = 5.0f;
+		float MinSecondsBetweenReports = 300.0f;
+		int32 MaxReportsPerMap = 1;
+		/** Hooks into end of frame and map loads and starts the watchdog thread. Off lets tests drive RecordFrame by hand */
+		bool bRegisterHooks = true;
+	};
+
+	/** A frame worth a report */
+	struct FDetection
+	{
+		FString Summary;
+		/** How far the measurement exceeds its threshold */
+		float Ratio = 0.0f;
+	};
+
+	explicit FCodecksPerformanceWatchdog(const FConfig& InConfig);
+	virtual ~FCodecksPerformanceWatchdog() override;
+
+	/** Maps how far a measurement exceeds its threshold to a report severity */
+	static ECodecksUserReportSeverity GetSeverityForOverrun(float Ratio);
+
+	/**
+	 * Adds a frame's game thread work time to the window and checks it against the hitch threshold and tick budget.
+	 * Returns true if the frame is worth a report, which then counts towards the rate limits. Filing it is up to the caller.
+	 */
+	bool RecordFrame(float WorkMs, double CurrentTime, FDetection& OutDetection);
+
+	/** Starts the grace period and per map report count of a new map */
+	void BeginMap(double CurrentTime);
+
+	/** Average work time over the last BudgetWindowFrames, 0 until the window filled up */
+	float GetBudgetWindowAverageMs() const;
+
+	//~ Begin FRunnable
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+	//~ End FRunnable
+
+private:
+	void OnEndFrame();
+	void OnPostLoadMap(UWorld* LoadedWorld);
+
+	float GetTickBudgetMs() const;
+	bool CanReport(double CurrentTime) const;
+
+	void FileReport(const FDetection& Detection);
+
+	FConfig Config;
+
+	// Game thread only
+	TStaticArray<float, WindowSize> FrameWorkMs;
+	int32 NextFrame = 0;
+	int32 RecordedFrames = 0;
+	double BudgetWindowSumMs = 0.0;
+	double IgnoreFramesUntil = 0.0;
+	double LastReportTime = -DBL_MAX;
+	int32 ReportsThisMap = 0;
+
+	// Shared with the watchdog thread
+	std::atomic<uint64> FrameStartCycles{0};
+	std::atomic<uint64> FrameNumber{0};
+	std::atomic<bool> bStopping{false};
+
+	FCriticalSection CallstackMutex;
+	TStaticArray<uint64, MaxCallstackDepth> Callstack;
+	int32 CallstackDepth = 0;
+	uint64 CallstackFrame = 0;
+
+	FRunnableThread* Thread = nullptr;
+	FEvent* WakeEvent = nullptr;
+
+	FDelegateHandle EndFrameHandle;
+	FDelegateHandle PostLoadMapHandle;
+};
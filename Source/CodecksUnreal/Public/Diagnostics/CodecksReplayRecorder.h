@@ -0,0 +1,43 @@
+// Copyright(C) battyRabbit UG (limited liability). All Rights Reserved.
+
+#pragma once
+
+#include <CoreMinimal.h>
+
+class UWorld;
+
+/**
+ * Records a replay of every game map into the in-memory ring buffer of the CodecksReplayStreaming module,
+ * so reports can carry the last seconds of the match as a network demo.
+ */
+class CODECKSUNREAL_API FCodecksReplayRecorder
+{
+public:
+	struct FConfig
+	{
+		float BufferSeconds = 60.0f;
+		int64 MemoryCapBytes = 32 * 1024 * 1024;
+		/**
+		 * The window is trimmed at checkpoints. 0 keeps the engine's interval.
+		 * The demo driver only reads it from the process wide demo.CheckpointUploadDelayInSeconds, so this sets
+		 * that cvar for every replay recorded while the recorder exists and restores it afterwards.
+		 */
+		float CheckpointInterval = 10.0f;
+	};
+
+	/** Url option making the demo driver use the codecks streamer */
+	static const FString StreamerOverrideOption;
+
+	static FString GetFilename() { return TEXT("replay.codecksreplay"); }
+
+	explicit FCodecksReplayRecorder(const FConfig& InConfig);
+	~FCodecksReplayRecorder();
+
+private:
+	void OnPostLoadMap(UWorld* LoadedWorld);
+
+	FDelegateHandle PostLoadMapHandle;
+
+	/** demo.CheckpointUploadDelayInSeconds before the recorder changed it, negative if left alone */
+	float PreviousCheckpointInterval = -1.0f;
+};
@@ -0,0 +1,54 @@
+// Copyright(C) battyRabbit UG (limited liability). All Rights Reserved.
+
+#pragma once
+
+#include <CoreMinimal.h>
+
+#include <HAL/CriticalSection.h>
+#include <Tasks/Task.h>
+
+/**
+ * System and build information attached to every report (CPU, GPU, RAM, OS, build, plugins and optionally the command line).
+ *
+ * Gathered once and asynchronously when the module starts, then kept as a pre-serialized json block so adding it
+ * to a report is just handing out a reference. Games can add their own fields with SetCustomField.
+ */
+class CODECKSUNREAL_API FCodecksSystemMetadata
+{
+public:
+	static FCodecksSystemMetadata& Get();
+
+	/** Name of the attachment the block is uploaded as */
+	static const TCHAR* GetFilename() { return TEXT("system-info.json"); }
+
+	/**
+	 * Kicks off gathering on a worker thread, to be called from the game thread.
+	 * @param bIncludeCommandLine Whether to add the command line, it may carry credentials (i.e. auth tokens) passed to the game
+	 */
+	void GatherAsync(bool bIncludeCommandLine);
+
+	/**
+	 * Adds or replaces a game specific field (i.e. save slot, matchmaking region or feature flags), safe from any thread.
+	 * Fields show up in the "custom" section of the block.
+	 */
+	void SetCustomField(const FString& Key, const FString& Value);
+
+	/**
+	 * The serialized UTF-8 json block, waiting for gathering if it is still in flight.
+	 * Only serializes again after custom fields changed.
+	 */
+	TSharedRef<const TArray64<uint8>, ESPMode::ThreadSafe> GetSerialized() const;
+
+private:
+	struct FGatheredMetadata
+	{
+		TArray<TPair<FString, FString>> Fields;
+		TArray<FString> EnabledPlugins;
+	};
+
+	mutable UE::Tasks::TTask<FGatheredMetadata> GatherTask;
+
+	mutable FCriticalSection Mutex;
+	TMap<FString, FString> CustomFields;
+	mutable TSharedPtr<const TArray64<uint8>, ESPMode::ThreadSafe> Serialized;
+};
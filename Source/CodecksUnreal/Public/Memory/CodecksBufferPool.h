@@ -0,0 +1,69 @@
+// Copyright(C) battyRabbit UG (limited liability). All Rights Reserved.
+
+#pragma once
+
+#include <CoreMinimal.h>
+
+#include <HAL/CriticalSection.h>
+
+struct FCodecksBufferPoolStats
+{
+	/** Buffers handed out in total */
+	int64 Acquired = 0;
+	/** Of those, served from the pool */
+	int64 Reused = 0;
+	/** Of those, newly allocated */
+	int64 Allocated = 0;
+	/** Buffers freed instead of pooled, as the pool was over budget */
+	int64 Dropped = 0;
+	/** Capacity currently held by the pool */
+	int64 PooledBytes = 0;
+};
+
+/**
+ * Size classed scratch buffers shared by the report paths (screenshot pixels, multipart upload bodies).
+ *
+ * Soak tests file thousands of reports per run, allocating a few megabytes of short lived buffers each time
+ * fragments the heap over long sessions. Buffers returned here keep their capacity for the next report instead.
+ * Size classes are powers of two, a buffer is pooled under the largest class its capacity covers.
+ */
+class CODECKSUNREAL_API FCodecksBufferPool
+{
+public:
+	static constexpr int32 MinSizeClassLog2 = 12;
+	static constexpr int32 NumSizeClasses = 16;
+	static constexpr int32 MaxBuffersPerClass = 4;
+
+	static FCodecksBufferPool& Get();
+
+	/**
+	 * @return An empty buffer with at least MinCapacity bytes of capacity
+	 */
+	TArray64<uint8> Acquire(int64 MinCapacity);
+
+	/**
+	 * Hands a buffer back, its contents are discarded. Safe from any thread.
+	 */
+	void Release(TArray64<uint8>&& Buffer);
+
+	/**
+	 * @param InMaxPooledBytes Capacity the pool may hold on to, buffers above that are freed on release
+	 */
+	void SetBudget(int64 InMaxPooledBytes);
+
+	/** Frees all pooled buffers */
+	void Trim();
+
+	FCodecksBufferPoolStats GetStats() const;
+
+private:
+	static int32 GetSizeClassForCapacity(int64 Capacity);
+
+	mutable FCriticalSection Mutex;
+
+	TArray<TArray64<uint8>> SizeClasses[NumSizeClasses];
+
+	int64 MaxPooledBytes = 64 * 1024 * 1024;
+
+	FCodecksBufferPoolStats Stats;
+};
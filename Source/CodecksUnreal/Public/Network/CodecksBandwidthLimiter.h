@@ -0,0 +1,106 @@
+// Copyright(C) battyRabbit UG (limited liability). All Rights Reserved.
+
+#pragma once
+
+#include <CoreMinimal.h>
+
+#include <HAL/CriticalSection.h>
+#include <Serialization/Archive.h>
+
+/**
+ * Process wide token bucket shared by all codecks uploads.
+ *
+ * Each upload is charged against the bucket when it starts and may leave it in debt, the next upload waits on its
+ * worker until that debt is paid off. This holds the average of all uploads to the limit without delaying a report's
+ * first upload. A single upload still goes out at link speed: the engine reads streamed content in full buffers on
+ * the HTTP thread shared by every request in the process, so its body can't be paced without stalling all of them.
+ * In adaptive mode the effective rate backs off multiplicatively whenever the game's net connection reports
+ * rising latency or packet loss and recovers additively once it settles again.
+ */
+class CODECKSUNREAL_API FCodecksBandwidthLimiter
+{
+public:
+	static FCodecksBandwidthLimiter& Get();
+
+	/**
+	 * @param InBytesPerSecond Upper bound for all uploads combined, 0 disables throttling
+	 * @param bInAdaptive Whether to react to ReportNetworkConditions, only has an effect with a limit set
+	 */
+	void Configure(int64 InBytesPerSecond, bool bInAdaptive);
+
+	/**
+	 * @param InLatencyTolerance Seconds of latency above the observed baseline that count as congestion
+	 * @param InPacketLossTolerance Packet loss ratio (0..1) that counts as congestion
+	 * @param InMinBytesPerSecond Lowest rate adaptive mode will back off to
+	 */
+	void ConfigureAdaptive(float InLatencyTolerance, float InPacketLossTolerance, int64 InMinBytesPerSecond);
+
+	bool IsThrottling() const { return BytesPerSecond > 0; }
+	bool IsAdaptive() const { return bAdaptive && IsThrottling(); }
+
+	int64 GetLimit() const { return BytesPerSecond; }
+	int64 GetEffectiveRate() const;
+
+	/**
+	 * Blocks the calling thread until earlier charges are paid off, then charges NumBytes. Meant for upload workers.
+	 * Never throttles the game thread, as that would stall the frame instead of the upload. This only happens when
+	 * the task graph runs without workers (i.e. -nothreading), a warning is logged once and uploads go unthrottled.
+	 */
+	void Charge(int64 NumBytes);
+
+	/**
+	 * Feeds the latest net driver sample into the adaptive rate.
+	 */
+	void ReportNetworkConditions(float LatencySeconds, float PacketLoss);
+
+private:
+	void Refill(double Now);
+
+	/** Tokens the bucket holds at most, it may fall below zero by the size of the last charge */
+	double GetCapacity() const;
+
+	mutable FCriticalSection Mutex;
+
+	int64 BytesPerSecond = 0;
+	int64 EffectiveBytesPerSecond = 0;
+	int64 MinBytesPerSecond = 4 * 1024;
+
+	double Tokens = 0.0;
+	double LastRefillTime = 0.0;
+
+	bool bAdaptive = false;
+	float LatencyTolerance = 0.05f;
+	float PacketLossTolerance = 0.02f;
+	float BaselineLatency = -1.0f;
+};
+
+/** Part of an upload body shared between requests, @see FCodecksAttachmentCache */
+using FCodecksUploadSection = TSharedRef<const TArray64<uint8>, ESPMode::ThreadSafe>;
+
+/**
+ * Read-only archive over an upload body, used as streamed request content.
+ * Runs on the HTTP thread and never blocks, pacing is up to FCodecksBandwidthLimiter::Charge before the upload starts.
+ *
+ * The body is read from up to three parts in order: Head, a shared section and Tail. Only the shared section is
+ * referenced rather than owned, Head is handed back to FCodecksBufferPool once the HTTP layer is done with it.
+ */
+class CODECKSUNREAL_API FCodecksUploadArchive : public FArchive
+{
+public:
+	explicit FCodecksUploadArchive(TArray64<uint8>&& InBytes);
+	FCodecksUploadArchive(TArray64<uint8>&& InHead, FCodecksUploadSection InShared, TArray64<uint8>&& InTail);
+	virtual ~FCodecksUploadArchive() override;
+
+	virtual void Serialize(void* Data, int64 Num) override;
+	virtual void Seek(int64 InPos) override { Offset = FMath::Clamp<int64>(InPos, 0, TotalSize()); }
+	virtual int64 Tell() override { return Offset; }
+	virtual int64 TotalSize() override { return Head.Num() + (Shared ? Shared->Num() : 0) + Tail.Num(); }
+	virtual FString GetArchiveName() const override { return TEXT("FCodecksUploadArchive"); }
+
+private:
+	TArray64<uint8> Head;
+	TSharedPtr<const TArray64<uint8>, ESPMode::ThreadSafe> Shared;
+	TArray64<uint8> Tail;
+
+	int64 Offset = 0;
+};
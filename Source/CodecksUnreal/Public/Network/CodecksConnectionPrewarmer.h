@@ -0,0 +1,50 @@
+// Copyright(C) battyRabbit UG (limited liability). All Rights Reserved.
+
+#pragma once
+
+#include <CoreMinimal.h>
+
+#include <HAL/CriticalSection.h>
+
+/**
+ * Opens connections to the api and upload hosts ahead of time.
+ *
+ * The first report of a session otherwise pays for DNS lookup and TLS setup twice, once for the api and once for
+ * the storage host. A cheap HEAD request per host does that in the background and leaves the connection in the
+ * HTTP module's connection cache for the actual report to reuse.
+ */
+class CODECKSUNREAL_API FCodecksConnectionPrewarmer
+{
+public:
+	static FCodecksConnectionPrewarmer& Get();
+
+	/**
+	 * Warms the api host, the configured upload host and all upload hosts seen in earlier reports.
+	 * Hosts warmed recently are skipped, so this is cheap to call whenever a report UI opens.
+	 */
+	void Prewarm();
+
+	/**
+	 * Warms the host of a single url.
+	 * @param OnWarmed Called on the game thread once the connection is established (or failed to)
+	 */
+	void PrewarmUrl(const FString& Url, FSimpleDelegate OnWarmed = FSimpleDelegate());
+
+	/**
+	 * Remembers the host of an upload url handed out by the api, so later pre-warms include it. Safe from any thread.
+	 */
+	void NoteUploadUrl(const FString& Url);
+
+	/**
+	 * @return scheme://host[:port]/ of Url, or an empty string if it isn't absolute
+	 */
+	static FString GetOrigin(const FString& Url);
+
+private:
+	FCriticalSection Mutex;
+
+	TSet<FString> UploadOrigins;
+
+	// Origin -> FPlatformTime::Seconds() of the last pre-warm
+	TMap<FString, double> LastWarmed;
+};
@@ -0,0 +1,120 @@
+// Copyright(C) battyRabbit UG (limited liability). All Rights Reserved.
+
+#pragma once
+
+#include <CoreMinimal.h>
+
+#include "Network/CodecksBandwidthLimiter.h"
+
+#include <HAL/CriticalSection.h>
+
+struct FCodecksAttachedFile;
+
+/**
+ * Attachment encoded once up front and shared by every report it is attached to (i.e. the build log of an automated run).
+ * Unlike the cache this skips hashing as well, whoever shares it already knows the content is the same.
+ */
+struct CODECKSUNREAL_API FCodecksSharedAttachment
+{
+	explicit FCodecksSharedAttachment(const FCodecksAttachedFile& File);
+
+	FString Filename;
+	FString ContentType;
+	FCodecksUploadSection Section;
+};
+
+struct FCodecksAttachmentCacheStats
+{
+	/** Uploads that reused an encoded section */
+	int64 Hits = 0;
+	/** Uploads that had to encode their section */
+	int64 Misses = 0;
+	/** Sections encoded for content seen before, and kept for the next upload */
+	int64 Admitted = 0;
+	/** Sections dropped to stay within budget */
+	int64 Evicted = 0;
+	/** Size of all sections currently cached */
+	int64 CachedBytes = 0;
+	int32 Entries = 0;
+};
+
+/**
+ * Process wide cache of encoded multipart file sections, keyed by a hash of the attachment's content.
+ *
+ * Automated runs attach the same build log or config dump to many reports. Each upload still hashes the payload,
+ * but encodes it into the form only once, every later upload streams the cached section by reference.
+ * Content is only admitted on its second sighting, one-off screenshots and dumps never take up the budget.
+ * Least recently used sections are evicted beyond the budget, sections still uploading stay alive until done.
+ * Sections that aren't kept are encoded into buffers from FCodecksBufferPool. Disabled unless a budget is set.
+ */
+class CODECKSUNREAL_API FCodecksAttachmentCache
+{
+public:
+	static FCodecksAttachmentCache& Get();
+
+	/**
+	 * @return The file's multipart section, from "Content-Disposition" up to and including its payload
+	 */
+	FCodecksUploadSection FindOrEncode(const FCodecksAttachedFile& File);
+
+	/**
+	 * Encodes the file's multipart section without looking at the cache.
+	 */
+	static TArray64<uint8> EncodeSection(const FCodecksAttachedFile& File);
+
+	/**
+	 * @param InMaxCachedBytes Size of all cached sections combined, 0 disables caching
+	 */
+	void SetBudget(int64 InMaxCachedBytes);
+
+	/** Drops all cached sections */
+	void Trim();
+
+	FCodecksAttachmentCacheStats GetStats() const;
+
+private:
+	struct FKey
+	{
+		uint64 ContentHash = 0;
+		int64 Size = 0;
+		FString Filename;
+		FString ContentType;
+
+		bool operator==(const FKey& Other) const
+		{
+			return ContentHash == Other.ContentHash && Size == Other.Size && Filename == Other.Filename && ContentType == Other.ContentType;
+		}
+	};
+
+	struct FEntry
+	{
+		FKey Key;
+		FCodecksUploadSection Section;
+	};
+
+	void EvictToBudget(TArray<FEntry>& OutEvicted);
+
+	/** Encodes a section that isn't kept into a pooled buffer, which goes back to the pool with the last reference */
+	static FCodecksUploadSection EncodePooled(const FCodecksAttachedFile& File);
+
+	/** Upper bound for the size of the file's encoded section */
+	static int64 GetSectionSize(const FCodecksAttachedFile& File);
+
+	static void EncodeSectionInto(const FCodecksAttachedFile& File, TArray64<uint8>& Bytes);
+
+	/** Whether the key was seen before, remembers it otherwise */
+	bool CheckSeen(const FKey& Key);
+
+	mutable FCriticalSection Mutex;
+
+	// Ordered from least to most recently used, few enough entries that linear search beats a map plus list
+	TArray<FEntry> Entries;
+
+	// Keys of content seen once, oldest first. Kept short, repeated attachments come back within a few reports
+	static constexpr int32 MaxSeenKeys = 64;
+	TArray<FKey> SeenKeys;
+
+	int64 MaxCachedBytes = 0;
+
+	FCodecksAttachmentCacheStats Stats;
+};
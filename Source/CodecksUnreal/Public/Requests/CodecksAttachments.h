@@ -0,0 +1,119 @@
+// Copyright(C) battyRabbit UG (limited liability). All Rights Reserved.
+
+#pragma once
+
+#include <CoreMinimal.h>
+
+#include <HAL/CriticalSection.h>
+
+#include "CodecksAttachments.generated.h"
+
+/**
+ * Stable handle to an attachment of a report.
+ * Handles are never reused, so one staying around after its attachment is gone just fails to resolve.
+ */
+USTRUCT(BlueprintType)
+struct CODECKSUNREAL_API FCodecksAttachmentHandle
+{
+	GENERATED_BODY()
+
+	FCodecksAttachmentHandle() = default;
+
+	bool IsValid() const { return Id != 0; }
+
+	bool operator==(const FCodecksAttachmentHandle& Other) const { return Id == Other.Id; }
+	bool operator!=(const FCodecksAttachmentHandle& Other) const { return Id != Other.Id; }
+
+	friend uint32 GetTypeHash(const FCodecksAttachmentHandle& Handle) { return Handle.Id; }
+
+private:
+	friend class FCodecksAttachmentList;
+
+	explicit FCodecksAttachmentHandle(uint32 InId)
+		: Id(InId)
+	{}
+
+	uint32 Id = 0;
+};
+
+/**
+ * Produces the payload of a lazy attachment.
+ * Runs on a worker thread and only once the server accepted the report and handed out an upload url for it.
+ * @return false if no data could be produced, the file is skipped then
+ */
+using FCodecksAttachmentProvider = TFunction<bool(TArray64<uint8>& OutBinary, FString& OutContentType)>;
+
+struct FCodecksAttachedFile
+{
+	FString Filename;
+	TArray64<uint8> Binary;
+	FString ContentType;
+
+	/** Set for lazy attachments, which have no payload until provided */
+	FCodecksAttachmentProvider Provider;
+
+	/** Set for shared attachments, uploaded as is instead of encoding Binary (which stays empty) */
+	TSharedPtr<const TArray64<uint8>, ESPMode::ThreadSafe> SharedSection;
+
+	bool IsLazy() const { return static_cast<bool>(Provider); }
+};
+
+using FCodecksAttachedFileRef = TSharedRef<const FCodecksAttachedFile, ESPMode::ThreadSafe>;
+
+/**
+ * Attachments of a single report, safe to register and fill from any thread.
+ *
+ * Files are immutable once published, updating the payload of a handle swaps in a new file instead of writing
+ * into the old one. That keeps the lock down to a few pointer operations and lets readers (i.e. the upload task)
+ * work on their references without holding it.
+ */
+class CODECKSUNREAL_API FCodecksAttachmentList
+{
+public:
+	/**
+	 * Registers a file name whose payload is provided later on with SetPayload (i.e. a pending screenshot).
+	 */
+	FCodecksAttachmentHandle Add(FString Filename);
+	FCodecksAttachmentHandle Add(FCodecksAttachedFile&& File);
+
+	/**
+	 * Registers a file name whose payload is only produced when it is about to be uploaded.
+	 */
+	FCodecksAttachmentHandle AddLazy(FString Filename, FCodecksAttachmentProvider Provider);
+
+	/**
+	 * Publishes the payload for a registered attachment.
+	 * @return false if the handle is unknown to this list
+	 */
+	bool SetPayload(const FCodecksAttachmentHandle& Handle, TArray64<uint8>&& Binary, FString ContentType);
+
+	TSharedPtr<const FCodecksAttachedFile, ESPMode::ThreadSafe> Find(const FCodecksAttachmentHandle& Handle) const;
+	TSharedPtr<const FCodecksAttachedFile, ESPMode::ThreadSafe> FindByFilename(const FString& Filename) const;
+
+	/**
+	 * Current attachments in registration order, unaffected by later changes to the list.
+	 */
+	TArray<FCodecksAttachedFileRef> GetSnapshot() const;
+
+	int32 Num() const;
+
+	/**
+	 * Runs the provider of a lazy attachment, blocking the calling thread.
+	 * @return The produced file, File itself if it isn't lazy or nullptr if the provider failed
+	 */
+	static TSharedPtr<const FCodecksAttachedFile, ESPMode::ThreadSafe> Provide(const FCodecksAttachedFileRef& File);
+
+private:
+	struct FSlot
+	{
+		uint32 Id;
+		FCodecksAttachedFileRef File;
+	};
+
+	int32 FindSlotIndex(uint32 Id) const;
+
+	mutable FRWLock Lock;
+
+	// Ordered by id, as ids only ever grow
+	TArray<FSlot> Slots;
+};
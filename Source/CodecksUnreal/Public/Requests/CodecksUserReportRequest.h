@@ -4,6 +4,8 @@
 
 #include <CoreMinimal.h>
 
+#include "CodecksAttachments.h"
+
 #include <Dom/JsonObject.h>
 #include <JsonObjectWrapper.h>
 #include <Tasks/Pipe.h>
@@ -11,7 +13,9 @@
 
 #include "CodecksUserReportRequest.generated.h"
 
+class FCodecksUploadArchive;
 class IHttpRequest;
+struct FCodecksSharedAttachment;
 
 UENUM(BlueprintType)
 enum class ECodecksUserReportSeverity : uint8
@@ -79,19 +83,37 @@ public:
 
 	/**
 	 * Creates an intermediate screenshot in memory and attaches it.
+	 * The handle is valid right away, the image data follows once the screenshot has been captured.
 	 */
 	UFUNCTION(BlueprintCallable)
-	void AttachIntermediateScreenshot(bool bShowUI = false);
+	FCodecksAttachmentHandle AttachIntermediateScreenshot(bool bShowUI = false);
 
 	void AddRequestData(const TSharedPtr<FJsonObject>& JsonObject);
 
 	UFUNCTION(BlueprintCallable)
 	bool IsActive() const { return RequestState > ECodecksRequestState::Initializing || HttpRequest.IsValid(); }
 
+	/**
+	 * Attaches a file to the report. Safe to call from any thread, so parallel systems can contribute their
+	 * dumps while the report is being built.
+	 */
 	UFUNCTION(BlueprintCallable)
-	void AttachFile(const FString& Filename, const FString& FileContents);
-	void AttachFile(const FString& Filename, TArray64<uint8>&& Binary, FString ContentType);
-	void AttachFile(const FString& Filename, const TArrayView64<uint8>& Binary, FString ContentType);
+	FCodecksAttachmentHandle AttachFile(const FString& Filename, const FString& FileContents);
+	FCodecksAttachmentHandle AttachFile(const FString& Filename, TArray64<uint8>&& Binary, FString ContentType);
+	FCodecksAttachmentHandle AttachFile(const FString& Filename, const TArrayView64<uint8>& Binary, FString ContentType);
+
+	/**
+	 * Attaches a file whose data is only produced, on a worker thread, once the server accepted the report.
+	 * Use it for expensive attachments (memreports, save-game exports, ...), so failed or rejected reports cost nothing to build.
+	 */
+	FCodecksAttachmentHandle AttachLazy(const FString& Filename, FCodecksAttachmentProvider Provider);
+
+	/**
+	 * Attaches a file encoded once for many reports, the report only references it instead of copying and hashing it.
+	 */
+	FCodecksAttachmentHandle AttachShared(const FCodecksSharedAttachment& Shared);
+
+	const FCodecksAttachmentList& GetAttachments() const { return Attachments; }
 
 	bool IsOk() const;
 	FName Error() const;
@@ -102,9 +124,39 @@ public:
 	UFUNCTION(BlueprintCallable)
 	void SetSeverity(ECodecksUserReportSeverity InSeverity) { Severity = InSeverity; }
 
+	/**
+	 * Opts this report out of the replay window attached by default (see UCodecksSettings::bRecordReplayForReports).
+	 * Saving the window takes about as much memory again as the ring buffer holds.
+	 */
+	UFUNCTION(BlueprintCallable)
+	void SetAttachReplay(bool bInAttachReplay) { bAttachReplay = bInAttachReplay; }
+
+	/** Opts this report out of system-info.json attached by default (see UCodecksSettings::bAttachSystemMetadata) */
+	UFUNCTION(BlueprintCallable)
+	void SetAttachSystemMetadata(bool bInAttachSystemMetadata) { bAttachSystemMetadata = bInAttachSystemMetadata; }
+
+	/**
+	 * Opens connections to the api and upload hosts in the background, call it when the report UI opens
+	 * so sending the report doesn't have to wait for DNS lookup and TLS setup.
+	 */
+	UFUNCTION(BlueprintCallable)
+	static void PrewarmConnections();
+
 	virtual void CreateReport();
 	virtual void CreateReport(const TFunction<void(UCodecksUserReportRequest* Request)>& UpdateCall);
 
+	/**
+	 * Builds the multipart/form-data body uploading File along with the storage host's form fields.
+	 * The form fields are written to a pooled buffer, the file itself is shared (@see FCodecksAttachmentCache).
+	 */
+	static TSharedRef<FCodecksUploadArchive, ESPMode::ThreadSafe> MakeUploadBody(const FCodecksAttachedFile& File, const FJsonObject& FormFields, const FString& FormBoundary);
+
+	/** Copies captured screenshot pixels into a buffer drawn from FCodecksBufferPool */
+	static TArray64<uint8> CopyScreenshotPixels(const TArray<FColor>& Colors);
+
+	/** Compresses pixels from CopyScreenshotPixels to png and hands their buffer back to the pool */
+	static TArray64<uint8> CompressScreenshot(int32 Width, int32 Height, TArray64<uint8>&& Pixels);
+
 	friend FJsonObject& operator<<(FJsonObject& Json, UCodecksUserReportRequest& Request);
 
 protected:
@@ -150,19 +202,18 @@ protected:
 	UPROPERTY(BlueprintReadWrite, meta=(ExposeOnSpawn))
 	FString UserEmail;
 
-	struct FAttachedFile
-	{
-		FString Filename;
-		TArray64<uint8> Binary;
-		FString ContentType;
-	};
+	UPROPERTY(BlueprintReadWrite, meta=(ExposeOnSpawn))
+	bool bAttachReplay = true;
+
+	UPROPERTY(BlueprintReadWrite, meta=(ExposeOnSpawn))
+	bool bAttachSystemMetadata = true;
 
 	UPROPERTY(Transient)
 	uint32 TotalBytesToSend = 0;
 	UPROPERTY(Transient)
 	uint32 TotalBytesSent = 0;
 
-	TArray<FAttachedFile> AttachedFiles;
+	FCodecksAttachmentList Attachments;
 
 	UE::Tasks::FPipe ScreenshotPipe = UE::Tasks::FPipe(UE_SOURCE_LOCATION);
 };
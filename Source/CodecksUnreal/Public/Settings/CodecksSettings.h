@@ -4,6 +4,10 @@
 
 #include <CoreMinimal.h>
 
+#include "Diagnostics/CodecksLowMemoryReporter.h"
+#include "Diagnostics/CodecksPerformanceWatchdog.h"
+#include "Diagnostics/CodecksReplayRecorder.h"
+
 #include "CodecksSettings.generated.h"
 
 class UCodecksUserReportService;
@@ -20,6 +24,39 @@ public:
 
 	FString GetApiUrl() const {return CodecksApiURL; }
 
+	bool ShouldPrewarmConnectionsOnStartup() const { return bPrewarmConnectionsOnStartup; }
+	FString GetPrewarmUploadUrl() const { return PrewarmUploadURL; }
+
+	bool IsPerformanceWatchdogEnabled() const { return bEnablePerformanceWatchdog; }
+	FCodecksPerformanceWatchdog::FConfig GetPerformanceWatchdogConfig() const;
+
+	bool IsLowMemoryReportEnabled() const { return bEnableLowMemoryReports; }
+	FCodecksLowMemoryReporter::FConfig GetLowMemoryReportConfig() const;
+
+	bool ShouldAttachSystemMetadata() const { return bAttachSystemMetadata; }
+	bool ShouldAttachCommandLine() const { return bAttachCommandLine; }
+
+	bool ShouldRecordReplayForReports() const { return bRecordReplayForReports; }
+	FCodecksReplayRecorder::FConfig GetReplayRecorderConfig() const;
+
+	int32 GetBufferPoolBudget() const { return BufferPoolBudget; }
+	int32 GetAttachmentCacheBudget() const { return AttachmentCacheBudget; }
+
+	int32 GetUploadBandwidthLimit() const { return UploadBandwidthLimit; }
+	bool IsAdaptiveUploadBandwidth() const { return bAdaptiveUploadBandwidth; }
+	float GetAdaptiveLatencyTolerance() const { return AdaptiveLatencyTolerance; }
+	float GetAdaptivePacketLossTolerance() const { return AdaptivePacketLossTolerance; }
+	int32 GetAdaptiveMinUploadBandwidth() const { return AdaptiveMinUploadBandwidth; }
+
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+	/**
+	 * Pushes the upload bandwidth settings to the shared limiter.
+	 */
+	void ApplyUploadBandwidth() const;
+
 protected:
 	/**
 	 * @brief Token get by codecks organization settings or generated(and injected) during build process.
@@ -33,4 +70,156 @@ protected:
 	UPROPERTY(Config, EditAnywhere)
 	FString CodecksApiURL;
 
+	/**
+	 * Opens connections to the api and upload hosts in the background when the module starts,
+	 * so the first report of a session doesn't pay for DNS lookup and TLS setup.
+	 * @see UCodecksUserReportRequest::PrewarmConnections to do so when the report UI opens instead
+	 */
+	UPROPERTY(Config, EditAnywhere)
+	bool bPrewarmConnectionsOnStartup = false;
+
+	/**
+	 * Upload (storage) host to pre-warm before the api handed out any upload url in this session.
+	 */
+	UPROPERTY(Config, EditAnywhere)
+	FString PrewarmUploadURL;
+
+	/**
+	 * Attaches system and build information (CPU, GPU, RAM, OS, build and plugins) to every report.
+	 * Gathered once at startup, @see FCodecksSystemMetadata to add game specific fields.
+	 */
+	UPROPERTY(Config, EditAnywhere)
+	bool bAttachSystemMetadata = true;
+
+	/**
+	 * Adds the command line to the system information. Off by default, launchers often pass credentials (i.e. auth tokens) on it.
+	 */
+	UPROPERTY(Config, EditAnywhere, meta=(EditCondition="bAttachSystemMetadata"))
+	bool bAttachCommandLine = false;
+
+	/**
+	 * Files reports on its own for hitches and tick budget overruns, on clients and dedicated servers (not in the editor).
+	 * Each report carries the recent frame times and the game thread callstack sampled during the hitch.
+	 */
+	UPROPERTY(Config, EditAnywhere)
+	bool bEnablePerformanceWatchdog = false;
+
+	/**
+	 * A single frame's game thread work time above this is a hitch.
+	 */
+	UPROPERTY(Config, EditAnywhere, meta=(EditCondition="bEnablePerformanceWatchdog", ClampMin=1, Units="Milliseconds"))
+	float HitchThreshold = 200.0f;
+
+	/**
+	 * Average game thread work time above this is a tick budget overrun, 0 derives it from the server tick rate (clients have no budget then).
+	 */
+	UPROPERTY(Config, EditAnywhere, meta=(EditCondition="bEnablePerformanceWatchdog", ClampMin=0, Units="Milliseconds"))
+	float TickBudget = 0.0f;
+
+	/**
+	 * Number of frames the tick budget is averaged over, so a single slow frame isn't an overrun yet.
+	 */
+	UPROPERTY(Config, EditAnywhere, meta=(EditCondition="bEnablePerformanceWatchdog", ClampMin=1, ClampMax=256))
+	int32 TickBudgetWindowFrames = 60;
+
+	UPROPERTY(Config, EditAnywhere, meta=(EditCondition="bEnablePerformanceWatchdog", ClampMin=0, Units="Seconds"))
+	float MinSecondsBetweenPerformanceReports = 300.0f;
+
+	/**
+	 * Keeps one bad level from producing a storm of reports.
+	 */
+	UPROPERTY(Config, EditAnywhere, meta=(EditCondition="bEnablePerformanceWatchdog", ClampMin=1))
+	int32 MaxPerformanceReportsPerMap = 1;
+
+	/**
+	 * Files a report with a compressed memory snapshot (platform stats, LLM tags, top UObject classes, streaming state)
+	 * when the platform sends a memory trim warning or free memory drops below LowMemoryThreshold.
+	 */
+	UPROPERTY(Config, EditAnywhere)
+	bool bEnableLowMemoryReports = false;
+
+	/**
+	 * Free physical memory below this also counts as a low memory warning, 0 only listens to the platform.
+	 */
+	UPROPERTY(Config, EditAnywhere, meta=(EditCondition="bEnableLowMemoryReports", ClampMin=0, Units="Megabytes"))
+	int32 LowMemoryThreshold = 0;
+
+	/**
+	 * Memory held back and released right before building the report, so it still has room to work with.
+	 */
+	UPROPERTY(Config, EditAnywhere, meta=(EditCondition="bEnableLowMemoryReports", ClampMin=0, Units="Kilobytes"))
+	int32 LowMemoryReserve = 1024;
+
+	UPROPERTY(Config, EditAnywhere, meta=(EditCondition="bEnableLowMemoryReports", ClampMin=0, Units="Seconds"))
+	float MinSecondsBetweenLowMemoryReports = 600.0f;
+
+	/**
+	 * Records a replay of the running match into a memory ring buffer and attaches its last seconds to every report.
+	 * Play it back with Codecks.PlayReplay after copying it to Saved/Demos.
+	 */
+	UPROPERTY(Config, EditAnywhere)
+	bool bRecordReplayForReports = false;
+
+	UPROPERTY(Config, EditAnywhere, meta=(EditCondition="bRecordReplayForReports", ClampMin=1, Units="Seconds"))
+	float ReplayBufferSeconds = 60.0f;
+
+	/**
+	 * Hard cap for the ring buffer, older parts of the window are dropped to stay below it.
+	 */
+	UPROPERTY(Config, EditAnywhere, meta=(EditCondition="bRecordReplayForReports", ClampMin=1, Units="Megabytes"))
+	int32 ReplayBufferMemoryCap = 32;
+
+	/**
+	 * The window is trimmed at checkpoints, so this is how much longer than ReplayBufferSeconds it may get. 0 keeps the engine's interval.
+	 * Note this sets the global demo.CheckpointUploadDelayInSeconds cvar, so it applies to all replays recorded in the process.
+	 */
+	UPROPERTY(Config, EditAnywhere, meta=(EditCondition="bRecordReplayForReports", ClampMin=0, Units="Seconds"))
+	float ReplayCheckpointInterval = 10.0f;
+
+	/**
+	 * Memory the plugin keeps around in scratch buffers (screenshot pixels, upload bodies) for reuse by later reports.
+	 * Keeps the heap from fragmenting when thousands of reports are filed, i.e. in soak tests. 0 disables pooling.
+	 */
+	UPROPERTY(Config, EditAnywhere, meta=(ClampMin=0, Units="Megabytes"))
+	int32 BufferPoolBudget = 64;
+
+	/**
+	 * Memory for upload-ready attachments kept around by content, so the same build log or config dump attached to
+	 * many reports is only encoded once. Content is kept from its second upload on, least recently used ones are
+	 * dropped beyond the budget. Off by default, only worth it when reports keep attaching the same files.
+	 */
+	UPROPERTY(Config, EditAnywhere, meta=(ClampMin=0, Units="Megabytes"))
+	int32 AttachmentCacheBudget = 0;
+
+	/**
+	 * Upper bound in bytes per second for all attachment uploads combined, 0 disables throttling.
+	 * Keeps a report with a large screenshot or log from saturating the uplink during a multiplayer session.
+	 */
+	UPROPERTY(Config, EditAnywhere, meta=(ClampMin=0, Units="Bytes"))
+	int32 UploadBandwidthLimit = 0;
+
+	/**
+	 * Backs off the upload rate while the game's net connection shows rising latency or packet loss.
+	 * Requires UploadBandwidthLimit, which is the rate it recovers to.
+	 */
+	UPROPERTY(Config, EditAnywhere, meta=(EditCondition="UploadBandwidthLimit > 0"))
+	bool bAdaptiveUploadBandwidth = false;
+
+	/**
+	 * Latency above the observed baseline that counts as congestion.
+	 */
+	UPROPERTY(Config, EditAnywhere, meta=(EditCondition="bAdaptiveUploadBandwidth", ClampMin=0, Units="Seconds"))
+	float AdaptiveLatencyTolerance = 0.05f;
+
+	/**
+	 * Packet loss ratio (0..1) that counts as congestion.
+	 */
+	UPROPERTY(Config, EditAnywhere, meta=(EditCondition="bAdaptiveUploadBandwidth", ClampMin=0, ClampMax=1))
+	float AdaptivePacketLossTolerance = 0.02f;
+
+	/**
+	 * Lowest rate in bytes per second adaptive mode backs off to.
+	 */
+	UPROPERTY(Config, EditAnywhere, meta=(EditCondition="bAdaptiveUploadBandwidth", ClampMin=1, Units="Bytes"))
+	int32 AdaptiveMinUploadBandwidth = 4 * 1024;
 };